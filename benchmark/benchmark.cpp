@@ -0,0 +1,50 @@
+#include "benchmark.h"
+
+#include <cstdio>
+#include <numeric>
+
+Benchmark::Benchmark(const Options &options) : m_options(options) {}
+
+std::vector< Benchmark::Size > Benchmark::sizes() const
+{
+    // Beginner and expert, then 12% and 21% densities on growing square boards.
+    const Size all[] = { { 9, 9, 10 },		   { 30, 16, 99 },		 { 100, 100, 1200 },	 { 100, 100, 2100 },
+                         { 200, 200, 4800 },	   { 200, 200, 8400 },	 { 500, 500, 30000 },	 { 500, 500, 52500 },
+                         { 2000, 2000, 480000 }, { 2000, 2000, 840000 } };
+    std::vector< Size > sizes;
+    for (const Size &size : all)
+    {
+        if (static_cast< long long >(size.width) * size.height <= m_options.maximumCells)
+            sizes.push_back(size);
+    }
+    return sizes;
+}
+
+int Benchmark::threads() const
+{
+    return m_options.threads;
+}
+
+bool Benchmark::enabled(const std::string &name) const
+{
+    return m_options.filter.empty() || name.find(m_options.filter) != std::string::npos;
+}
+
+void Benchmark::report(const std::string &name, const Size &size, std::vector< double > &samples) const
+{
+    std::sort(samples.begin(), samples.end());
+    double minimum = samples.front();
+    double median = samples[samples.size() / 2];
+    double mean = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+    if (m_options.json)
+    {
+        std::printf("{\"benchmark\": \"%s\", \"width\": %d, \"height\": %d, \"mines\": %d, \"repetitions\": %zu, "
+                    "\"min_ns\": %.1f, \"median_ns\": %.1f, \"mean_ns\": %.1f}\n",
+                    name.c_str(), size.width, size.height, size.mines, samples.size(), minimum, median, mean);
+    }
+    else
+    {
+        std::printf("%s,%d,%d,%d,%zu,%.1f,%.1f,%.1f\n", name.c_str(), size.width, size.height, size.mines, samples.size(), minimum, median, mean);
+    }
+    std::fflush(stdout);
+}
@@ -0,0 +1,74 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Benchmark
+{
+public:
+    struct Size
+    {
+        int width;
+        int height;
+        int mines;
+    };
+    struct Options
+    {
+        std::string filter;
+        bool json = false;
+        int warmup = 2;
+        int minimumRepetitions = 5;
+        int maximumRepetitions = 1000;
+        double minimumSeconds = 0.2;
+        long long maximumCells = 4000000;
+        int threads = 0;
+    };
+    explicit Benchmark(const Options &options);
+
+    std::vector< Size > sizes() const;
+    bool enabled(const std::string &name) const;
+    int threads() const;
+
+    // setup() runs untimed before every repetition; body() is timed and returns how many operations it performed.
+    template< typename Setup, typename Body >
+    void run(const std::string &name, const Size &size, Setup setup, Body body) const
+    {
+        if (!enabled(name))
+            return;
+        for (int i = 0; i < m_options.warmup; ++i)
+        {
+            setup();
+            body();
+        }
+        std::vector< double > samples;
+        double elapsed = 0;
+        while (static_cast< int >(samples.size()) < m_options.maximumRepetitions &&
+               (static_cast< int >(samples.size()) < m_options.minimumRepetitions || elapsed < m_options.minimumSeconds))
+        {
+            setup();
+            auto begin = std::chrono::steady_clock::now();
+            long long operations = body();
+            double seconds = std::chrono::duration< double >(std::chrono::steady_clock::now() - begin).count();
+            elapsed += seconds;
+            samples.push_back(seconds * 1e9 / std::max(1LL, operations));
+        }
+        report(name, size, samples);
+    }
+
+    static const std::uint64_t Seed = 20240601;
+
+private:
+    void report(const std::string &name, const Size &size, std::vector< double > &samples) const;
+
+    Options m_options;
+};
+
+void runEngineBenchmarks(const Benchmark &benchmark);
+void runWidgetBenchmarks(const Benchmark &benchmark);
+bool runReplayBenchmarks(const Benchmark &benchmark, const std::string &path);
+
+#endif	  // BENCHMARK_H
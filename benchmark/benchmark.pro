@@ -0,0 +1,45 @@
+QT       += core gui
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+CONFIG += c++17 console release
+CONFIG -= app_bundle debug
+
+TARGET = minesweeper-benchmark
+
+INCLUDEPATH += ..
+
+SOURCES += \
+    ../boardmodel.cpp \
+    ../boardview.cpp \
+    ../celltiles.cpp \
+    ../chunkedboard.cpp \
+    ../gamelogic.cpp \
+    ../gamerules.cpp \
+    ../latency.cpp \
+    ../noguessgenerator.cpp \
+    ../probabilityengine.cpp \
+    ../replay.cpp \
+    ../savegame.cpp \
+    ../seededrandom.cpp \
+    ../solver.cpp \
+    benchmark.cpp \
+    enginebenchmarks.cpp \
+    main.cpp \
+    widgetbenchmarks.cpp
+
+HEADERS += \
+    ../boardmodel.h \
+    ../boardview.h \
+    ../celltiles.h \
+    ../chunkedboard.h \
+    ../gamelogic.h \
+    ../gamerules.h \
+    ../latency.h \
+    ../noguessgenerator.h \
+    ../probabilityengine.h \
+    ../replay.h \
+    ../savegame.h \
+    ../seededrandom.h \
+    ../solver.h \
+    benchmark.h
@@ -0,0 +1,130 @@
+#include "benchmark.h"
+
+#include "boardmodel.h"
+#include "chunkedboard.h"
+#include "noguessgenerator.h"
+#include "solver.h"
+
+void runEngineBenchmarks(const Benchmark &benchmark)
+{
+    for (const Benchmark::Size &size : benchmark.sizes())
+    {
+        int cells = size.width * size.height;
+        // Generation runs in row bands from a million cells up; --threads sets how many threads share them,
+        // and copies of prepared carry the setting along.
+        BoardModel prepared;
+        prepared.setThreadCount(benchmark.threads());
+        prepared.reset(size.width, size.height);
+        prepared.placeMines(size.mines, Benchmark::Seed);
+        prepared.calculateAdjacentMines();
+        int start = prepared.index(size.height / 2, size.width / 2);
+        prepared.clearSafeZone(start, true, ~Benchmark::Seed);
+
+        BoardModel board = prepared;
+        benchmark.run(
+            "engine/placeMines",
+            size,
+            [&]() { board.reset(size.width, size.height); },
+            [&]()
+            {
+                board.placeMines(size.mines, Benchmark::Seed);
+                return 1LL;
+            });
+        benchmark.run(
+            "engine/calculateAdjacentMines",
+            size,
+            [&]() { board = prepared; },
+            [&]()
+            {
+                board.calculateAdjacentMines();
+                return 1LL;
+            });
+        benchmark.run(
+            "engine/openAdjacentCells",
+            size,
+            [&]() { board = prepared; },
+            [&]()
+            {
+                board.openArea(start);
+                return 1LL;
+            });
+        benchmark.run(
+            "engine/checkWinCondition",
+            size,
+            [&]() { board = prepared; },
+            [&]()
+            {
+                // Volatile pointer and result, so the call can be neither hoisted out of the loop nor dropped.
+                BoardModel *volatile target = &board;
+                volatile bool cleared;
+                for (int i = 0; i < 1000; ++i)
+                    cleared = target->isCleared();
+                (void)cleared;
+                return 1000LL;
+            });
+        ChunkedBoard chunked;
+        benchmark.run(
+            "engine/chunkedOpenArea",
+            size,
+            [&]() { chunked.reset(size.width, size.height, size.mines, Benchmark::Seed); },
+            [&]()
+            {
+                // Chunks are built inside the timed region, as they would be on a first click; the opening differs
+                // from BoardModel's since the mines come from the chunk hash, so the time is per opened cell. The
+                // flood is run to the end here, step after step, rather than across event loop passes.
+                chunked.setSafeZone(size.height / 2, size.width / 2);
+                std::int64_t opened = chunked.openArea(size.height / 2, size.width / 2);
+                while (chunked.isFlooding())
+                    opened += chunked.continueFlood();
+                return static_cast< long long >(opened);
+            });
+        // Packed up front, so engine/unpack has its input even when --filter skips engine/pack.
+        std::vector< std::uint8_t > packed = prepared.pack();
+        benchmark.run(
+            "engine/pack",
+            size,
+            []() {},
+            [&]()
+            {
+                packed = prepared.pack();
+                return 1LL;
+            });
+        benchmark.run(
+            "engine/unpack",
+            size,
+            []() {},
+            [&]()
+            {
+                board.unpack(size.width, size.height, packed.data(), packed.size());
+                return 1LL;
+            });
+        Solver solver(board);
+        benchmark.run(
+            "engine/solve",
+            size,
+            [&]()
+            {
+                board = prepared;
+                board.openArea(start);
+                solver.reset();
+            },
+            [&]()
+            {
+                solver.solve();
+                return 1LL;
+            });
+        if (cells <= 10000)
+        {
+            benchmark.run(
+                "engine/noGuessGenerate",
+                size,
+                []() {},
+                [&]()
+                {
+                    int noGuessStart;
+                    NoGuessGenerator(size.width, size.height, size.mines).generate(Benchmark::Seed, board, noGuessStart);
+                    return 1LL;
+                });
+        }
+    }
+}
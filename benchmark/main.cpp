@@ -0,0 +1,68 @@
+#include "benchmark.h"
+
+#include <QApplication>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+int main(int argc, char *argv[])
+{
+    Benchmark::Options options;
+    bool engineOnly = false;
+    std::string replay;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string option(argv[i]);
+        bool hasValue = i + 1 < argc;
+        if (option == "--filter" && hasValue)
+            options.filter = argv[++i];
+        else if (option == "--max-cells" && hasValue)
+            options.maximumCells = std::atoll(argv[++i]);
+        else if (option == "--min-time" && hasValue)
+            options.minimumSeconds = std::atof(argv[++i]);
+        else if (option == "--repetitions" && hasValue)
+            options.minimumRepetitions = std::atoi(argv[++i]);
+        else if (option == "--threads" && hasValue)
+            options.threads = std::atoi(argv[++i]);
+        else if (option == "--quick")
+            options.maximumCells = 10000;
+        else if (option == "--replay" && hasValue)
+            replay = argv[++i];
+        else if (option == "--engine-only")
+            engineOnly = true;
+        else if (option == "--json")
+            options.json = true;
+        else if (option == "-platform" && hasValue)
+            ++i;
+        else
+        {
+            std::fprintf(stderr,
+                         "usage: %s [--filter TEXT] [--max-cells N] [--min-time SECONDS] [--repetitions N] [--threads N] [--quick] [--engine-only] [--replay FILE] [--json]\n"
+                         "widget benchmarks need a display; use -platform offscreen on headless machines\n",
+                         argv[0]);
+            return 2;
+        }
+    }
+    Benchmark benchmark(options);
+    if (!options.json)
+        std::printf("benchmark,width,height,mines,repetitions,min_ns,median_ns,mean_ns\n");
+    if (!replay.empty())
+    {
+        // A recorded game replaces the synthetic suites.
+        QApplication app(argc, argv);
+        if (!runReplayBenchmarks(benchmark, replay))
+        {
+            std::fprintf(stderr, "%s: not a replay file\n", replay.c_str());
+            return 1;
+        }
+        return 0;
+    }
+    runEngineBenchmarks(benchmark);
+    if (!engineOnly)
+    {
+        QApplication app(argc, argv);
+        runWidgetBenchmarks(benchmark);
+    }
+    return 0;
+}
@@ -0,0 +1,267 @@
+#include "benchmark.h"
+
+#include "boardview.h"
+#include "gamelogic.h"
+#include "replay.h"
+#include "savegame.h"
+
+#include <QApplication>
+#include <QFile>
+#include <QGridLayout>
+#include <QTemporaryDir>
+
+#include <memory>
+
+namespace
+{
+const QSize WindowSize(1000, 1000);
+
+struct GameArea
+{
+    bool changeDbg = false;
+    bool leftHanded = false;
+    bool safeOpening = true;
+    bool noGuess = false;
+    bool firstMove = true;
+    bool rus = false;
+    quint64 seed = Benchmark::Seed;
+    std::unique_ptr< QWidget > widget;
+    GameLogic *logic = nullptr;
+    BoardView *view = nullptr;
+
+    // The same objects and connections MainWindow::setupGameArea builds, minus menus and persistence.
+    void build(BoardModel &board)
+    {
+        widget.reset(new QWidget);
+        QGridLayout *layout = new QGridLayout(widget.get());
+        layout->setSpacing(0);
+        logic = new GameLogic(changeDbg, leftHanded, safeOpening, noGuess, firstMove, rus, seed, board, widget.get());
+        view = new BoardView(board, widget.get());
+        QObject::connect(view, &BoardView::cellClicked, logic, &GameLogic::handleCellClick);
+        QObject::connect(logic, &GameLogic::cellsChanged, view, &BoardView::refreshCells);
+        QObject::connect(logic, &GameLogic::cellsHighlighted, view, &BoardView::setHighlighted);
+        QObject::connect(logic,
+                         &GameLogic::boardRevealed,
+                         view,
+                         [this](int clickedMine)
+                         {
+                             view->setExploded(clickedMine);
+                             view->refreshAll();
+                         });
+        layout->addWidget(view, 0, 0);
+        widget->resize(WindowSize);
+    }
+};
+
+void startReplay(const Replay::Header &header, BoardModel &board, GameArea &area)
+{
+    board.unpack(header.width, header.height, header.cells.data(), header.cells.size());
+    area.logic->startGame(-1);
+    area.firstMove = header.firstMove;
+    area.safeOpening = header.safeOpening;
+}
+}	 // namespace
+
+void runWidgetBenchmarks(const Benchmark &benchmark)
+{
+    QTemporaryDir directory;
+    QString path = directory.filePath("gamestate.bin");
+    for (const Benchmark::Size &size : benchmark.sizes())
+    {
+        BoardModel prepared;
+        prepared.reset(size.width, size.height);
+        prepared.placeMines(size.mines, Benchmark::Seed);
+        prepared.calculateAdjacentMines();
+        int start = prepared.index(size.height / 2, size.width / 2);
+        prepared.clearSafeZone(start, true, ~Benchmark::Seed);
+
+        BoardModel board;
+        GameArea area;
+        // Every benchmark sets up its own starting position, so any of them can run alone under --filter.
+        auto prepare = [&]()
+        {
+            board = prepared;
+            if (area.widget)
+                area.view->resetBoard();
+            else
+                area.build(board);
+        };
+        benchmark.run(
+            "widget/createGameArea",
+            size,
+            [&]() { area.widget.reset(); },
+            [&]()
+            {
+                // Model setup, widget construction and the first frame, as a new game does.
+                board.reset(size.width, size.height);
+                area.build(board);
+                area.logic->placeMines(size.mines);
+                area.widget->grab();
+                return 1LL;
+            });
+        benchmark.run(
+            "widget/restartGameArea",
+            size,
+            [&]()
+            {
+                if (!area.widget)
+                    area.build(board);
+            },
+            [&]()
+            {
+                // A restart keeps the widgets and only swaps the model under them, as MainWindow::showGameArea does.
+                board.reset(size.width, size.height);
+                area.view->resetBoard();
+                area.logic->placeMines(size.mines);
+                area.widget->grab();
+                return 1LL;
+            });
+        benchmark.run(
+            "widget/firstClick",
+            size,
+            [&]()
+            {
+                board = prepared;
+                area.build(board);
+                area.firstMove = false;
+                area.widget->grab();
+            },
+            [&]()
+            {
+                area.logic->handleCellClick(start, Qt::LeftButton);
+                area.widget->grab();
+                return 1LL;
+            });
+        benchmark.run(
+            "widget/revealAllCells",
+            size,
+            [&]()
+            {
+                board = prepared;
+                area.build(board);
+                area.widget->grab();
+            },
+            [&]()
+            {
+                area.logic->revealAllCells();
+                area.widget->grab();
+                return 1LL;
+            });
+        benchmark.run(
+            "widget/repaint",
+            size,
+            [&]()
+            {
+                prepare();
+                area.logic->revealAllCells();
+            },
+            [&]()
+            {
+                area.widget->grab();
+                return 1LL;
+            });
+        benchmark.run(
+            "widget/flagCell",
+            size,
+            [&]()
+            {
+                // On screen, so the update goes through the real dirty-region path instead of a full grab().
+                prepare();
+                area.widget->show();
+                QApplication::processEvents();
+            },
+            [&]()
+            {
+                area.logic->handleCellClick(start, Qt::RightButton);
+                QApplication::processEvents();
+                return 1LL;
+            });
+        if (area.widget)
+            area.widget->hide();
+        // The same snapshot MainWindow::saveGameState writes, packed from the live board inside the timed region.
+        SaveGame::Snapshot snapshot;
+        snapshot.width = size.width;
+        snapshot.height = size.height;
+        snapshot.mines = size.mines;
+        snapshot.seed = Benchmark::Seed;
+        benchmark.run(
+            "io/saveGameState",
+            size,
+            []() {},
+            [&]()
+            {
+                snapshot.cells = prepared.pack();
+                SaveGame::write(path, snapshot);
+                return 1LL;
+            });
+        benchmark.run(
+            "io/loadGameState",
+            size,
+            [&]()
+            {
+                snapshot.cells = prepared.pack();
+                SaveGame::write(path, snapshot);
+            },
+            [&]()
+            {
+                SaveGame::Snapshot loaded;
+                if (SaveGame::read(path, loaded))
+                    board.unpack(loaded.width, loaded.height, loaded.cells.data(), loaded.cells.size());
+                return 1LL;
+            });
+        area.widget.reset();
+    }
+}
+
+bool runReplayBenchmarks(const Benchmark &benchmark, const std::string &path)
+{
+    QFile file(QString::fromStdString(path));
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    QByteArray data = file.readAll();
+    Replay::Header header;
+    std::vector< Replay::Move > moves;
+    if (!Replay::decode(reinterpret_cast< const std::uint8_t * >(data.constData()), std::size_t(data.size()), header, moves))
+        return false;
+    // Times are per recorded move: a real game's mix of clicks, chords and flags instead of a synthetic one.
+    Benchmark::Size size { header.width, header.height, header.mines };
+    BoardModel board;
+    GameArea area;
+    area.build(board);
+    benchmark.run(
+        "replay/headless",
+        size,
+        [&]()
+        {
+            startReplay(header, board, area);
+            area.view->setUpdatesEnabled(false);
+        },
+        [&]()
+        {
+            for (const Replay::Move &move : moves)
+            {
+                area.logic->playMove(move.index, Qt::MouseButton(move.button));
+            }
+            return static_cast< long long >(moves.size());
+        });
+    benchmark.run(
+        "replay/widget",
+        size,
+        [&]()
+        {
+            area.view->setUpdatesEnabled(true);
+            startReplay(header, board, area);
+            area.view->resetBoard();
+            area.widget->grab();
+        },
+        [&]()
+        {
+            for (const Replay::Move &move : moves)
+            {
+                area.logic->playMove(move.index, Qt::MouseButton(move.button));
+                area.widget->grab();
+            }
+            return static_cast< long long >(moves.size());
+        });
+    return true;
+}
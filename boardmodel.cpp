@@ -0,0 +1,565 @@
+#include "boardmodel.h"
+
+#include "seededrandom.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <limits>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+void addRows(const std::uint8_t *first, const std::uint8_t *second, const std::uint8_t *third, std::uint8_t *out, int count)
+{
+    int i = 0;
+#if defined(__AVX2__)
+    for (; i + 32 <= count; i += 32)
+    {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast< const __m256i * >(first + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast< const __m256i * >(second + i));
+        __m256i c = _mm256_loadu_si256(reinterpret_cast< const __m256i * >(third + i));
+        _mm256_storeu_si256(reinterpret_cast< __m256i * >(out + i), _mm256_add_epi8(_mm256_add_epi8(a, b), c));
+    }
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+    for (; i + 16 <= count; i += 16)
+    {
+        __m128i a = _mm_loadu_si128(reinterpret_cast< const __m128i * >(first + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast< const __m128i * >(second + i));
+        __m128i c = _mm_loadu_si128(reinterpret_cast< const __m128i * >(third + i));
+        _mm_storeu_si128(reinterpret_cast< __m128i * >(out + i), _mm_add_epi8(_mm_add_epi8(a, b), c));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        out[i] = first[i] + second[i] + third[i];
+    }
+}
+
+// Boards from this size on are generated in row bands of about BandCells cells, each band with its own
+// random stream. Smaller boards keep the single Floyd pass, so their boards for a given seed are unchanged.
+const int ParallelCells = 1 << 20;
+const int BandCells = 1 << 16;
+
+// How many of draws cells, picked without replacement from population cells, fall among a given successes of
+// them. Inversion over the weights relative to the mode's, which only take +, -, * and /, so every platform
+// draws the same count; weights below 2^-70 of the mode's are left out.
+std::int64_t hypergeometric(std::int64_t population, std::int64_t successes, std::int64_t draws, SeededRandom &random)
+{
+    std::int64_t low = std::max< std::int64_t >(0, draws - (population - successes));
+    std::int64_t high = std::min(successes, draws);
+    if (low == high)
+        return low;
+    std::int64_t mode = std::min(high, std::max(low, (draws + 1) * (successes + 1) / (population + 2)));
+    // ratio(x) = weight(x + 1) / weight(x)
+    auto ratio = [&](std::int64_t x)
+    { return double(successes - x) * double(draws - x) / (double(x + 1) * double(population - successes - draws + x + 1)); };
+    const double smallest = 1.0 / 1180591620717411303424.0;
+    std::vector< double > below;
+    double weight = 1;
+    for (std::int64_t x = mode; x > low && weight >= smallest; --x)
+    {
+        weight /= ratio(x - 1);
+        below.push_back(weight);
+    }
+    std::vector< double > weights(below.rbegin(), below.rend());
+    weights.push_back(1);
+    weight = 1;
+    for (std::int64_t x = mode; x < high && weight >= smallest; ++x)
+    {
+        weight *= ratio(x);
+        weights.push_back(weight);
+    }
+    double sum = 0;
+    for (double w : weights)
+        sum += w;
+    double target = double(random.next() >> 11) / 9007199254740992.0 * sum;
+    std::int64_t first = mode - static_cast< std::int64_t >(below.size());
+    for (std::size_t i = 0; i < weights.size(); ++i)
+    {
+        target -= weights[i];
+        if (target < 0)
+            return first + static_cast< std::int64_t >(i);
+    }
+    return first + static_cast< std::int64_t >(weights.size()) - 1;
+}
+
+template< typename Work >
+void forEachBand(int bands, int threads, Work work)
+{
+    std::atomic< int > next(0);
+    auto worker = [&]()
+    {
+        for (int band = next++; band < bands; band = next++)
+            work(band);
+    };
+    std::vector< std::thread > pool;
+    for (int t = 1; t < threads; ++t)
+        pool.emplace_back(worker);
+    worker();
+    for (std::thread &thread : pool)
+        thread.join();
+}
+}	 // namespace
+
+BoardModel::BoardModel() : m_width(0), m_height(0), m_mineCount(0), m_flagCount(0), m_openedSafeCount(0), m_threadCount(0) {}
+
+void BoardModel::reset(int width, int height)
+{
+    m_width = width;
+    m_height = height;
+    m_mineCount = 0;
+    m_flagCount = 0;
+    m_openedSafeCount = 0;
+    m_cells.assign(static_cast< std::size_t >(width) * height, 0);
+}
+
+void BoardModel::setThreadCount(int threads)
+{
+    m_threadCount = threads;
+}
+
+int BoardModel::width() const
+{
+    return m_width;
+}
+
+int BoardModel::height() const
+{
+    return m_height;
+}
+
+int BoardModel::cellCount() const
+{
+    return static_cast< int >(m_cells.size());
+}
+
+int BoardModel::index(int row, int col) const
+{
+    return row * m_width + col;
+}
+
+int BoardModel::row(int index) const
+{
+    return index / m_width;
+}
+
+int BoardModel::col(int index) const
+{
+    return index % m_width;
+}
+
+bool BoardModel::contains(int row, int col) const
+{
+    return row >= 0 && row < m_height && col >= 0 && col < m_width;
+}
+
+int BoardModel::neighbours(int index, int *out) const
+{
+    int row = index / m_width;
+    int col = index % m_width;
+    int count = 0;
+    for (int i = -1; i <= 1; ++i)
+    {
+        for (int j = -1; j <= 1; ++j)
+        {
+            if (i == 0 && j == 0)
+                continue;
+            if (contains(row + i, col + j))
+            {
+                out[count++] = index + i * m_width + j;
+            }
+        }
+    }
+    return count;
+}
+
+bool BoardModel::isMine(int index) const
+{
+    return m_cells[index] & MineBit;
+}
+
+bool BoardModel::isOpened(int index) const
+{
+    return state(index) == Opened;
+}
+
+int BoardModel::adjacentMines(int index) const
+{
+    return m_cells[index] & AdjacentMask;
+}
+
+BoardModel::State BoardModel::state(int index) const
+{
+    return static_cast< State >((m_cells[index] & StateMask) >> StateShift);
+}
+
+int BoardModel::mineCount() const
+{
+    return m_mineCount;
+}
+
+int BoardModel::flagCount() const
+{
+    return m_flagCount;
+}
+
+int BoardModel::openedSafeCount() const
+{
+    return m_openedSafeCount;
+}
+
+int BoardModel::remainingMines() const
+{
+    return m_mineCount - m_flagCount;
+}
+
+bool BoardModel::isCleared() const
+{
+    return m_openedSafeCount == cellCount() - m_mineCount;
+}
+
+void BoardModel::setMine(int index, bool hasMine)
+{
+    if (isMine(index) == hasMine)
+        return;
+    int delta = hasMine ? 1 : -1;
+    m_mineCount += delta;
+    if (isOpened(index))
+        m_openedSafeCount -= delta;
+    if (hasMine)
+        m_cells[index] |= MineBit;
+    else
+        m_cells[index] &= ~MineBit;
+}
+
+void BoardModel::setAdjacentMines(int index, int count)
+{
+    m_cells[index] = (m_cells[index] & ~AdjacentMask) | (count & AdjacentMask);
+}
+
+void BoardModel::setState(int index, State state)
+{
+    State previous = BoardModel::state(index);
+    if (previous == state)
+        return;
+    if (!isMine(index))
+    {
+        if (previous == Opened)
+            --m_openedSafeCount;
+        else if (state == Opened)
+            ++m_openedSafeCount;
+    }
+    if (previous == Flagged)
+        --m_flagCount;
+    else if (state == Flagged)
+        ++m_flagCount;
+    m_cells[index] = (m_cells[index] & ~StateMask) | (state << StateShift);
+}
+
+std::size_t BoardModel::packedSize(int width, int height)
+{
+    std::size_t count = static_cast< std::size_t >(width) * height;
+    return (count + 7) / 8 + (count + 3) / 4;
+}
+
+std::vector< std::uint8_t > BoardModel::pack() const
+{
+    // A mine bit plane followed by a 2-bit state plane; adjacency is recomputed on unpack.
+    std::size_t count = m_cells.size();
+    std::vector< std::uint8_t > packed(packedSize(m_width, m_height), 0);
+    std::uint8_t *mines = packed.data();
+    std::uint8_t *states = mines + (count + 7) / 8;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        mines[i >> 3] |= ((m_cells[i] & MineBit) >> 4) << (i & 7);
+        states[i >> 2] |= ((m_cells[i] & StateMask) >> StateShift) << ((i & 3) * 2);
+    }
+    return packed;
+}
+
+bool BoardModel::unpack(int width, int height, const std::uint8_t *data, std::size_t size)
+{
+    if (width < 1 || height < 1 || static_cast< long long >(width) * height > std::numeric_limits< int >::max() || size != packedSize(width, height))
+        return false;
+    reset(width, height);
+    std::size_t count = m_cells.size();
+    const std::uint8_t *mines = data;
+    const std::uint8_t *states = mines + (count + 7) / 8;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        bool mine = (mines[i >> 3] >> (i & 7)) & 1;
+        int state = (states[i >> 2] >> ((i & 3) * 2)) & 3;
+        m_cells[i] = (mine ? MineBit : 0) | (state << StateShift);
+        if (mine)
+            ++m_mineCount;
+        else if (state == Opened)
+            ++m_openedSafeCount;
+        if (state == Flagged)
+            ++m_flagCount;
+    }
+    calculateAdjacentMines();
+    return true;
+}
+
+void BoardModel::placeMines(int mines, std::uint64_t seed)
+{
+    // Floyd's sampling over a freshly reset board; the mine bit doubles as the "already chosen" set.
+    int total = cellCount();
+    if (total < ParallelCells)
+    {
+        SeededRandom random(seed);
+        for (int last = total - mines; last < total; ++last)
+        {
+            int candidate = static_cast< int >(random.bounded(last + 1));
+            setMine(isMine(candidate) ? last : candidate, true);
+        }
+        return;
+    }
+    // A uniform board, split so the bands can be filled at once: first how many mines each band holds, drawn
+    // band after band from one stream as a hypergeometric split of the mines still to place over the cells
+    // still to fill, then each band's positions from a stream seeded by the band number alone. Bands depend on
+    // the width, never on the thread count, so any thread count, one included, builds the same board.
+    //
+    // This is a different board for a given seed than the single Floyd pass above, a deliberate break for
+    // boards of ParallelCells cells and more: every step of that pass depends on all the earlier ones, so
+    // keeping its boards would mean keeping it serial. Seeds of smaller boards still give the boards they did.
+    int rows = bandRows();
+    int bands = (m_height + rows - 1) / rows;
+    std::vector< int > counts(bands);
+    SeededRandom split(SeededRandom(~seed).next());
+    std::int64_t cellsLeft = total;
+    std::int64_t minesLeft = mines;
+    for (int band = 0; band < bands; ++band)
+    {
+        std::int64_t cells = std::min< std::int64_t >(cellsLeft, static_cast< std::int64_t >(rows) * m_width);
+        counts[band] = static_cast< int >(hypergeometric(cellsLeft, cells, minesLeft, split));
+        cellsLeft -= cells;
+        minesLeft -= counts[band];
+    }
+    forEachBand(bands,
+                threadsFor(bands),
+                [&](int band)
+                {
+                    int begin = band * rows * m_width;
+                    int end = static_cast< int >(std::min< std::int64_t >(total, static_cast< std::int64_t >(begin) + rows * m_width));
+                    int count = counts[band];
+                    SeededRandom random(SeededRandom(seed + static_cast< std::uint64_t >(band)).next());
+                    std::uint8_t *cells = m_cells.data() + begin;
+                    int size = end - begin;
+                    for (int last = size - count; last < size; ++last)
+                    {
+                        int candidate = static_cast< int >(random.bounded(last + 1));
+                        cells[cells[candidate] & MineBit ? last : candidate] |= MineBit;
+                    }
+                });
+    m_mineCount += mines;
+}
+
+void BoardModel::moveMine(int from, int to)
+{
+    int adjacent[8];
+    setMine(from, false);
+    int mineCount = 0;
+    int count = neighbours(from, adjacent);
+    for (int k = 0; k < count; ++k)
+    {
+        if (isMine(adjacent[k]))
+            ++mineCount;
+        else
+            setAdjacentMines(adjacent[k], adjacentMines(adjacent[k]) - 1);
+    }
+    setAdjacentMines(from, mineCount);
+    setMine(to, true);
+    count = neighbours(to, adjacent);
+    for (int k = 0; k < count; ++k)
+    {
+        if (!isMine(adjacent[k]))
+            setAdjacentMines(adjacent[k], adjacentMines(adjacent[k]) + 1);
+    }
+}
+
+bool BoardModel::clearSafeZone(int index, bool withNeighbours, std::uint64_t seed)
+{
+    int zone[9];
+    int zoneSize = withNeighbours ? neighbours(index, zone) : 0;
+    zone[zoneSize++] = index;
+    int zoneMines = 0;
+    for (int k = 0; k < zoneSize; ++k)
+    {
+        if (isMine(zone[k]))
+            ++zoneMines;
+    }
+    if (zoneMines == 0)
+        return true;
+    int freeOutside = cellCount() - zoneSize - (m_mineCount - zoneMines);
+    if (freeOutside < zoneMines)
+        return withNeighbours && clearSafeZone(index, false, seed);
+    int zoneRow = row(index);
+    int zoneCol = col(index);
+    auto outsideZone = [&](int cell)
+    {
+        if (!withNeighbours)
+            return cell != index;
+        return std::abs(row(cell) - zoneRow) > 1 || std::abs(col(cell) - zoneCol) > 1;
+    };
+    SeededRandom random(seed);
+    for (int k = 0; k < zoneSize; ++k)
+    {
+        if (!isMine(zone[k]))
+            continue;
+        int target = -1;
+        for (int attempt = 0; attempt < 64 && target < 0; ++attempt)
+        {
+            int candidate = static_cast< int >(random.bounded(cellCount()));
+            if (!isMine(candidate) && outsideZone(candidate))
+                target = candidate;
+        }
+        if (target < 0)
+        {
+            // Dense board: pick the n-th free cell instead of rejecting forever.
+            int skip = static_cast< int >(random.bounded(freeOutside));
+            for (int candidate = 0; target < 0; ++candidate)
+            {
+                if (!isMine(candidate) && outsideZone(candidate) && skip-- == 0)
+                    target = candidate;
+            }
+        }
+        moveMine(zone[k], target);
+        --freeOutside;
+    }
+    return true;
+}
+
+void BoardModel::calculateAdjacentMines()
+{
+    // Mines as a zero-padded 0/1 byte plane, so every 3x3 sum is two passes of lane-wise additions:
+    // three rows summed vertically, then three shifted copies of that sum horizontally.
+    // Large boards run both passes in row bands. The plane is complete before the second pass starts, so a band
+    // reads the rows above and below it from the plane while its neighbours rewrite their own cells.
+    int stride = m_width + 2;
+    std::vector< std::uint8_t > mines(static_cast< std::size_t >(m_height + 2) * stride, 0);
+    int rows = cellCount() < ParallelCells ? m_height : bandRows();
+    int bands = (m_height + rows - 1) / rows;
+    int threads = threadsFor(bands);
+    forEachBand(bands,
+                threads,
+                [&](int band)
+                {
+                    for (int row = band * rows; row < std::min(m_height, (band + 1) * rows); ++row)
+                    {
+                        const std::uint8_t *cells = m_cells.data() + static_cast< std::size_t >(row) * m_width;
+                        std::uint8_t *plane = mines.data() + static_cast< std::size_t >(row + 1) * stride + 1;
+                        for (int col = 0; col < m_width; ++col)
+                        {
+                            plane[col] = (cells[col] & MineBit) >> 4;
+                        }
+                    }
+                });
+    forEachBand(bands,
+                threads,
+                [&](int band)
+                {
+                    std::vector< std::uint8_t > vertical(stride);
+                    std::vector< std::uint8_t > block(m_width);
+                    for (int row = band * rows; row < std::min(m_height, (band + 1) * rows); ++row)
+                    {
+                        const std::uint8_t *middle = mines.data() + static_cast< std::size_t >(row + 1) * stride;
+                        addRows(middle - stride, middle, middle + stride, vertical.data(), stride);
+                        addRows(vertical.data(), vertical.data() + 1, vertical.data() + 2, block.data(), m_width);
+                        std::uint8_t *cells = m_cells.data() + static_cast< std::size_t >(row) * m_width;
+                        for (int col = 0; col < m_width; ++col)
+                        {
+                            if (!(cells[col] & MineBit))
+                                cells[col] = (cells[col] & ~AdjacentMask) | (block[col] - middle[col + 1]);
+                        }
+                    }
+                });
+}
+
+std::vector< int > BoardModel::openArea(int index)
+{
+    std::vector< int > opened;
+    if (state(index) != Hidden)
+        return opened;
+    setState(index, Opened);
+    opened.push_back(index);
+    flood(opened);
+    return opened;
+}
+
+std::vector< int > BoardModel::openNeighbours(int index)
+{
+    // A chord: every hidden neighbour seeds the same breadth-first fill, so touching openings are walked once.
+    // The caller has already checked that none of them is a mine.
+    std::vector< int > opened;
+    int adjacent[8];
+    int count = neighbours(index, adjacent);
+    for (int k = 0; k < count; ++k)
+    {
+        if (state(adjacent[k]) == Hidden)
+        {
+            setState(adjacent[k], Opened);
+            opened.push_back(adjacent[k]);
+        }
+    }
+    flood(opened);
+    return opened;
+}
+
+void BoardModel::flood(std::vector< int > &opened)
+{
+    int adjacent[8];
+    for (std::size_t next = 0; next < opened.size(); ++next)
+    {
+        int current = opened[next];
+        if (adjacentMines(current) > 0)
+            continue;
+        int count = neighbours(current, adjacent);
+        for (int k = 0; k < count; ++k)
+        {
+            if (state(adjacent[k]) == Hidden)
+            {
+                setState(adjacent[k], Opened);
+                opened.push_back(adjacent[k]);
+            }
+        }
+    }
+}
+
+void BoardModel::openAll()
+{
+    // One pass over the bytes; the counts follow directly instead of being tracked cell by cell.
+    for (std::uint8_t &cell : m_cells)
+    {
+        cell = (cell & ~StateMask) | (Opened << StateShift);
+    }
+    m_flagCount = 0;
+    m_openedSafeCount = cellCount() - m_mineCount;
+}
+
+int BoardModel::bandRows() const
+{
+    return std::max(1, BandCells / m_width);
+}
+
+int BoardModel::threadsFor(int bands) const
+{
+    if (cellCount() < ParallelCells)
+        return 1;
+    int threads = m_threadCount > 0 ? m_threadCount : static_cast< int >(std::max(1u, std::thread::hardware_concurrency()));
+    return std::min(threads, bands);
+}
+
+const std::uint8_t *BoardModel::data() const
+{
+    return m_cells.data();
+}
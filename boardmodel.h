@@ -0,0 +1,85 @@
+#ifndef BOARDMODEL_H
+#define BOARDMODEL_H
+
+#include <cstdint>
+#include <vector>
+
+class BoardModel
+{
+public:
+    enum State
+    {
+        Hidden,
+        Opened,
+        Flagged,
+        Question
+    };
+    BoardModel();
+
+    void reset(int width, int height);
+    void setThreadCount(int threads);
+
+    int width() const;
+    int height() const;
+    int cellCount() const;
+
+    int index(int row, int col) const;
+    int row(int index) const;
+    int col(int index) const;
+    bool contains(int row, int col) const;
+    int neighbours(int index, int *out) const;
+
+    bool isMine(int index) const;
+    bool isOpened(int index) const;
+    int adjacentMines(int index) const;
+    State state(int index) const;
+
+    int mineCount() const;
+    int flagCount() const;
+    int openedSafeCount() const;
+    int remainingMines() const;
+    bool isCleared() const;
+
+    void setMine(int index, bool hasMine);
+    void setAdjacentMines(int index, int count);
+    void setState(int index, State state);
+
+    static std::size_t packedSize(int width, int height);
+    std::vector< std::uint8_t > pack() const;
+    bool unpack(int width, int height, const std::uint8_t *data, std::size_t size);
+
+    void placeMines(int mines, std::uint64_t seed);
+    void moveMine(int from, int to);
+    bool clearSafeZone(int index, bool withNeighbours, std::uint64_t seed);
+    void calculateAdjacentMines();
+    std::vector< int > openArea(int index);
+    std::vector< int > openNeighbours(int index);
+    void openAll();
+
+    const std::uint8_t *data() const;
+
+private:
+    // One byte per cell: bits 0-3 adjacent mines, bit 4 mine, bits 5-6 state.
+    enum : std::uint8_t
+    {
+        AdjacentMask = 0x0f,
+        MineBit = 0x10,
+        StateShift = 5,
+        StateMask = 0x60
+    };
+
+    void flood(std::vector< int > &opened);
+    int bandRows() const;
+    int threadsFor(int bands) const;
+
+    int m_width;
+    int m_height;
+    int m_mineCount;
+    int m_flagCount;
+    int m_openedSafeCount;
+    int m_threadCount;
+
+    std::vector< std::uint8_t > m_cells;
+};
+
+#endif	  // BOARDMODEL_H
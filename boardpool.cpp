@@ -0,0 +1,98 @@
+#include "boardpool.h"
+
+#include <algorithm>
+
+BoardPool::BoardPool(std::uint64_t seed, std::size_t capacity) :
+    m_capacity(capacity), m_limit(0), m_seeds(seed), m_width(0), m_height(0), m_mines(0), m_noGuess(false), m_generation(0), m_failed(false),
+    m_stopping(false), m_generator(nullptr)
+{
+    m_thread = std::thread(&BoardPool::run, this);
+}
+
+BoardPool::~BoardPool()
+{
+    {
+        std::lock_guard< std::mutex > lock(m_mutex);
+        m_stopping = true;
+        if (m_generator)
+            m_generator->cancel();
+    }
+    m_wake.notify_one();
+    m_thread.join();
+}
+
+void BoardPool::configure(int width, int height, int mines, bool noGuess)
+{
+    std::lock_guard< std::mutex > lock(m_mutex);
+    if (width == m_width && height == m_height && mines == m_mines && noGuess == m_noGuess)
+        return;
+    m_width = width;
+    m_height = height;
+    m_mines = mines;
+    m_noGuess = noGuess;
+    // A BoardModel holds one byte per cell, so the budget turns straight into a board count.
+    std::size_t cells = static_cast< std::size_t >(width) * static_cast< std::size_t >(height);
+    m_limit = cells > 0 ? std::min(m_capacity, MemoryBudget / cells) : 0;
+    ++m_generation;
+    m_failed = false;
+    m_ready.clear();
+    if (m_generator)
+        m_generator->cancel();
+    m_wake.notify_one();
+}
+
+bool BoardPool::take(Entry &entry)
+{
+    std::lock_guard< std::mutex > lock(m_mutex);
+    if (m_ready.empty())
+        return false;
+    entry = std::move(m_ready.front());
+    m_ready.pop_front();
+    m_wake.notify_one();
+    return true;
+}
+
+void BoardPool::run()
+{
+    // Boards are built exactly as a fresh game with the same seed would build them, only off the GUI thread.
+    std::unique_lock< std::mutex > lock(m_mutex);
+    for (;;)
+    {
+        m_wake.wait(lock, [this]() { return m_stopping || (m_width > 0 && !m_failed && m_ready.size() < m_limit); });
+        if (m_stopping)
+            return;
+        int width = m_width;
+        int height = m_height;
+        int mines = m_mines;
+        bool noGuess = m_noGuess;
+        std::uint64_t generation = m_generation;
+        Entry entry;
+        entry.seed = m_seeds.next();
+        NoGuessGenerator generator(width, height, mines);
+        generator.setThreadCount(1);
+        if (noGuess)
+            m_generator = &generator;
+        lock.unlock();
+
+        bool built = true;
+        if (noGuess)
+        {
+            built = generator.generate(entry.seed, entry.board, entry.start);
+        }
+        else
+        {
+            entry.board.reset(width, height);
+            entry.board.placeMines(mines, entry.seed);
+            entry.board.calculateAdjacentMines();
+        }
+
+        lock.lock();
+        m_generator = nullptr;
+        if (generation != m_generation)
+            continue;
+        if (built)
+            m_ready.push_back(std::move(entry));
+        else
+            m_failed = true;
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef BOARDPOOL_H
+#define BOARDPOOL_H
+
+#include "boardmodel.h"
+#include "noguessgenerator.h"
+#include "seededrandom.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+class BoardPool
+{
+public:
+    struct Entry
+    {
+        BoardModel board;
+        std::uint64_t seed = 0;
+        int start = -1;
+    };
+    // At most capacity boards are kept, and together they stay within MemoryBudget bytes, so a huge custom
+    // board is not pooled at all and restarts build it in the foreground as before.
+    enum
+    {
+        MemoryBudget = 1 << 22
+    };
+    explicit BoardPool(std::uint64_t seed, std::size_t capacity = 3);
+    ~BoardPool();
+
+    void configure(int width, int height, int mines, bool noGuess);
+    bool take(Entry &entry);
+
+private:
+    void run();
+
+    std::size_t m_capacity;
+    std::size_t m_limit;
+    SeededRandom m_seeds;
+
+    int m_width;
+    int m_height;
+    int m_mines;
+    bool m_noGuess;
+    std::uint64_t m_generation;
+    bool m_failed;
+    bool m_stopping;
+    NoGuessGenerator *m_generator;
+
+    std::deque< Entry > m_ready;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::thread m_thread;
+};
+
+#endif	  // BOARDPOOL_H
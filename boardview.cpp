@@ -0,0 +1,402 @@
+#include "boardview.h"
+
+#include "latency.h"
+
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QMouseEvent>
+#include <QScrollBar>
+#include <QWheelEvent>
+
+namespace
+{
+const QColor HighlightColor(255, 255, 0);
+const QColor HeatColor(255, 0, 0);
+}	 // namespace
+
+BoardView::BoardView(const BoardModel &board, QWidget *parent) :
+    QAbstractScrollArea(parent), m_board(board), m_cellSize(DefaultCellSize), m_exploded(-1), m_fitToView(true), m_peek(false),
+    m_heatMapVisible(false), m_progressive(true), m_interiorHeat(0), m_revealNext(0), m_revealStep(0),
+    m_paintTime(0)
+{
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    setFrameShape(QFrame::NoFrame);
+    connect(&m_revealTimer, &QTimer::timeout, this, &BoardView::revealStep);
+}
+
+int BoardView::cellSize() const
+{
+    return m_cellSize;
+}
+
+void BoardView::setCellSize(int size)
+{
+    m_fitToView = false;
+    zoom(size, viewport()->rect().center());
+}
+
+void BoardView::resetBoard()
+{
+    m_revealTimer.stop();
+    m_revealQueue.clear();
+    m_concealed.clear();
+    m_exploded = -1;
+    m_peek = false;
+    m_fitToView = true;
+    m_highlighted.clear();
+    m_heat.clear();
+    fitToView();
+    updateGeometry();
+    viewport()->update();
+}
+
+void BoardView::refreshCell(int index)
+{
+    viewport()->update(cellRect(index));
+}
+
+void BoardView::refreshCells(const std::vector< int > &indexes)
+{
+    if (m_progressive && indexes.size() >= ProgressiveCells && isVisible())
+    {
+        // The model is already final; only the drawing is spread out. A pending reveal is completed first.
+        finishReveal();
+        m_concealed.assign(m_board.cellCount(), 0);
+        for (int index : indexes)
+        {
+            m_concealed[index] = 1;
+        }
+        m_revealQueue = indexes;
+        m_revealNext = 0;
+        m_revealStep = 0;
+        revealStep();
+        m_revealTimer.start(RevealInterval);
+        return;
+    }
+    updateCells(indexes.data(), indexes.size());
+}
+
+void BoardView::refreshAll()
+{
+    finishReveal();
+    viewport()->update();
+}
+
+void BoardView::setProgressiveReveal(bool enabled)
+{
+    m_progressive = enabled;
+    if (!enabled)
+        finishReveal();
+}
+
+void BoardView::finishReveal()
+{
+    if (m_revealQueue.empty())
+        return;
+    m_revealTimer.stop();
+    m_concealed.clear();
+    updateCells(m_revealQueue.data() + m_revealNext, m_revealQueue.size() - m_revealNext);
+    m_revealQueue.clear();
+}
+
+void BoardView::revealStep()
+{
+    std::size_t step = qMax(std::size_t(MinimumRevealStep), m_revealQueue.size() / RevealFrames);
+    qint64 budget = qint64(RevealBudget) * 1000000;
+    if (m_revealStep > 0 && m_paintTime > budget)
+        step = qMin(step, qMax(std::size_t(1), std::size_t(m_revealStep * budget / m_paintTime)));
+    std::size_t end = qMin(m_revealQueue.size(), m_revealNext + step);
+    std::size_t first = m_revealNext;
+    for (; m_revealNext < end; ++m_revealNext)
+    {
+        m_concealed[m_revealQueue[m_revealNext]] = 0;
+    }
+    m_revealStep = m_revealNext - first;
+    updateCells(m_revealQueue.data() + first, m_revealNext - first);
+    if (m_revealNext == m_revealQueue.size())
+    {
+        m_revealTimer.stop();
+        m_revealQueue.clear();
+        m_concealed.clear();
+    }
+}
+
+void BoardView::updateCells(const int *indexes, std::size_t count)
+{
+    // The dirty cells on screen become one span per row, and rows with the same span merge into one rectangle,
+    // so an opening repaints about its own outline and cells scrolled out of view cost nothing.
+    if (count == 0)
+        return;
+    if (count == 1)
+    {
+        refreshCell(indexes[0]);
+        return;
+    }
+    QPoint origin = boardOrigin();
+    int firstRow = qMax(0, -origin.y() / m_cellSize);
+    int lastRow = qMin(m_board.height() - 1, (viewport()->height() - 1 - origin.y()) / m_cellSize);
+    int firstCol = qMax(0, -origin.x() / m_cellSize);
+    int lastCol = qMin(m_board.width() - 1, (viewport()->width() - 1 - origin.x()) / m_cellSize);
+    if (lastRow < firstRow || lastCol < firstCol)
+        return;
+    std::vector< int > spanFirst(lastRow - firstRow + 1, lastCol + 1);
+    std::vector< int > spanLast(lastRow - firstRow + 1, firstCol - 1);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        int row = m_board.row(indexes[i]);
+        int col = m_board.col(indexes[i]);
+        if (row < firstRow || row > lastRow || col < firstCol || col > lastCol)
+            continue;
+        spanFirst[row - firstRow] = qMin(spanFirst[row - firstRow], col);
+        spanLast[row - firstRow] = qMax(spanLast[row - firstRow], col);
+    }
+    QRegion region;
+    QRect pending;
+    for (int row = firstRow; row <= lastRow; ++row)
+    {
+        int first = spanFirst[row - firstRow];
+        int last = spanLast[row - firstRow];
+        if (last < first)
+            continue;
+        QRect span(origin.x() + first * m_cellSize, origin.y() + row * m_cellSize, (last - first + 1) * m_cellSize, m_cellSize);
+        if (!pending.isNull() && pending.left() == span.left() && pending.right() == span.right() && pending.bottom() + 1 == span.top())
+        {
+            pending.setBottom(span.bottom());
+            continue;
+        }
+        if (!pending.isNull())
+            region += pending;
+        pending = span;
+    }
+    if (!pending.isNull())
+        region += pending;
+    viewport()->update(region);
+}
+
+void BoardView::setHighlighted(const QVector< int > &indexes, bool highlighted)
+{
+    for (int index : indexes)
+    {
+        if (highlighted)
+            m_highlighted.insert(index);
+        else
+            m_highlighted.remove(index);
+        refreshCell(index);
+    }
+}
+
+void BoardView::setPeek(bool peek)
+{
+    m_peek = peek;
+    viewport()->update();
+}
+
+void BoardView::setExploded(int index)
+{
+    m_exploded = index;
+}
+
+void BoardView::setHeatMap(const ProbabilityEngine::Result &result, bool visible)
+{
+    m_heatMapVisible = visible;
+    m_heat.clear();
+    m_interiorHeat = result.interiorProbability;
+    for (std::size_t i = 0; i < result.cells.size(); ++i)
+    {
+        m_heat.insert(result.cells[i], result.probabilities[i]);
+    }
+    viewport()->update();
+}
+
+QSize BoardView::sizeHint() const
+{
+    return QSize(qMin(m_board.width() * DefaultCellSize, int(MaximumSizeHint)), qMin(m_board.height() * DefaultCellSize, int(MaximumSizeHint)));
+}
+
+void BoardView::changeEvent(QEvent *event)
+{
+    if (event->type() == QEvent::PaletteChange || event->type() == QEvent::FontChange)
+        m_tiles.invalidate();
+    QAbstractScrollArea::changeEvent(event);
+}
+
+void BoardView::paintEvent(QPaintEvent *event)
+{
+    Latency::Scope timing(Latency::Render);
+    QElapsedTimer clock;
+    clock.start();
+    if (!m_tiles.isValid(m_cellSize, devicePixelRatioF()))
+        m_tiles.build(m_cellSize, devicePixelRatioF(), palette(), font());
+    QPainter painter(viewport());
+    QPoint origin = boardOrigin();
+    QFont font = painter.font();
+    font.setPixelSize(qMax(6, m_cellSize / 2));
+    painter.setFont(font);
+    // Only the cells under each rectangle of the dirty region are drawn, not everything in its bounding box.
+    // Each pass is clipped to its own rectangle: a cell straddling two must not get its overlays blended twice.
+    for (const QRect &area : event->region())
+    {
+        painter.setClipRect(area);
+        painter.fillRect(area, palette().window());
+        int firstCol = qMax(0, (area.left() - origin.x()) / m_cellSize);
+        int lastCol = qMin(m_board.width() - 1, (area.right() - origin.x()) / m_cellSize);
+        int firstRow = qMax(0, (area.top() - origin.y()) / m_cellSize);
+        int lastRow = qMin(m_board.height() - 1, (area.bottom() - origin.y()) / m_cellSize);
+        for (int row = firstRow; row <= lastRow; ++row)
+        {
+            for (int col = firstCol; col <= lastCol; ++col)
+            {
+                QRect rect(origin.x() + col * m_cellSize, origin.y() + row * m_cellSize, m_cellSize, m_cellSize);
+                drawCell(painter, m_board.index(row, col), rect);
+            }
+        }
+    }
+    m_paintTime = clock.nsecsElapsed();
+}
+
+void BoardView::mousePressEvent(QMouseEvent *event)
+{
+    // A click acts on the board as it really is, so whatever is still being revealed appears at once.
+    finishReveal();
+    int index = cellAt(event->pos());
+    if (index < 0)
+        return;
+    Qt::MouseButton button = event->button();
+    if (button == Qt::LeftButton || button == Qt::RightButton)
+    {
+        emit cellClicked(index, button);
+    }
+    else if (button == Qt::MiddleButton)
+    {
+        if (m_board.isOpened(index) && m_board.adjacentMines(index) > 0)
+        {
+            emit cellClicked(index, button);
+        }
+    }
+}
+
+void BoardView::wheelEvent(QWheelEvent *event)
+{
+    if (!(event->modifiers() & Qt::ControlModifier))
+    {
+        QAbstractScrollArea::wheelEvent(event);
+        return;
+    }
+    int delta = event->angleDelta().y();
+    if (delta != 0)
+    {
+        int step = qMax(1, m_cellSize / 8);
+        m_fitToView = false;
+        zoom(delta > 0 ? m_cellSize + step : m_cellSize - step, event->position().toPoint());
+    }
+    event->accept();
+}
+
+void BoardView::resizeEvent(QResizeEvent *event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    fitToView();
+}
+
+void BoardView::scrollContentsBy(int dx, int dy)
+{
+    viewport()->scroll(dx, dy);
+}
+
+int BoardView::tileFor(int index) const
+{
+    if (!m_concealed.empty() && m_concealed[index])
+        return CellTiles::HiddenTile;
+    return CellTiles::tileFor(m_board.state(index), m_board.isMine(index), m_board.adjacentMines(index), m_peek, index == m_exploded);
+}
+
+void BoardView::drawCell(QPainter &painter, int index, const QRect &rect) const
+{
+    painter.drawPixmap(rect.topLeft(), m_tiles.tile(tileFor(index)));
+    if (m_board.state(index) != BoardModel::Hidden)
+        return;
+    if (m_heatMapVisible)
+    {
+        double heat = m_heat.value(index, m_interiorHeat);
+        QColor color = HeatColor;
+        color.setAlphaF(0.1 + 0.7 * heat);
+        painter.fillRect(rect.adjusted(1, 1, -1, -1), color);
+        if (m_cellSize >= 24 && !(m_peek && m_board.isMine(index)))
+        {
+            painter.setPen(palette().color(QPalette::ButtonText));
+            painter.drawText(rect, Qt::AlignCenter, QString::number(qRound(heat * 100)) + "%");
+        }
+    }
+    if (m_highlighted.contains(index))
+    {
+        painter.setPen(QPen(HighlightColor, 2));
+        painter.drawRect(rect.adjusted(1, 1, -1, -1));
+    }
+}
+
+QPoint BoardView::boardOrigin() const
+{
+    qint64 boardWidth = qint64(m_board.width()) * m_cellSize;
+    qint64 boardHeight = qint64(m_board.height()) * m_cellSize;
+    int x = boardWidth < viewport()->width() ? (viewport()->width() - int(boardWidth)) / 2 : -horizontalScrollBar()->value();
+    int y = boardHeight < viewport()->height() ? (viewport()->height() - int(boardHeight)) / 2 : -verticalScrollBar()->value();
+    return QPoint(x, y);
+}
+
+QRect BoardView::cellRect(int index) const
+{
+    QPoint origin = boardOrigin();
+    return QRect(origin.x() + m_board.col(index) * m_cellSize, origin.y() + m_board.row(index) * m_cellSize, m_cellSize, m_cellSize);
+}
+
+int BoardView::cellAt(const QPoint &pos) const
+{
+    QPoint point = pos - boardOrigin();
+    if (point.x() < 0 || point.y() < 0)
+        return -1;
+    int row = point.y() / m_cellSize;
+    int col = point.x() / m_cellSize;
+    if (!m_board.contains(row, col))
+        return -1;
+    return m_board.index(row, col);
+}
+
+void BoardView::zoom(int size, const QPoint &anchor)
+{
+    size = qBound(int(MinimumCellSize), size, int(MaximumCellSize));
+    if (size == m_cellSize)
+        return;
+    QPoint origin = boardOrigin();
+    double boardX = double(anchor.x() - origin.x()) / m_cellSize;
+    double boardY = double(anchor.y() - origin.y()) / m_cellSize;
+    m_cellSize = size;
+    updateScrollBars();
+    horizontalScrollBar()->setValue(qRound(boardX * m_cellSize) - anchor.x());
+    verticalScrollBar()->setValue(qRound(boardY * m_cellSize) - anchor.y());
+    viewport()->update();
+}
+
+void BoardView::fitToView()
+{
+    if (m_fitToView && m_board.cellCount() > 0)
+    {
+        int fit = qMin(viewport()->width() / m_board.width(), viewport()->height() / m_board.height());
+        m_cellSize = qBound(int(DefaultCellSize), fit, int(MaximumCellSize));
+    }
+    updateScrollBars();
+}
+
+void BoardView::updateScrollBars()
+{
+    // Taken in 64 bits and clamped: MainWindow keeps new boards within MaximumSide, but a board from elsewhere
+    // may be wider, and then only its first int's worth of pixels can be scrolled to.
+    qint64 maximum = std::numeric_limits< int >::max();
+    qint64 boardWidth = qint64(m_board.width()) * m_cellSize;
+    qint64 boardHeight = qint64(m_board.height()) * m_cellSize;
+    horizontalScrollBar()->setRange(0, int(qBound< qint64 >(0, boardWidth - viewport()->width(), maximum)));
+    horizontalScrollBar()->setPageStep(viewport()->width());
+    horizontalScrollBar()->setSingleStep(m_cellSize);
+    verticalScrollBar()->setRange(0, int(qBound< qint64 >(0, boardHeight - viewport()->height(), maximum)));
+    verticalScrollBar()->setPageStep(viewport()->height());
+    verticalScrollBar()->setSingleStep(m_cellSize);
+}
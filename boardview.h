@@ -0,0 +1,115 @@
+#ifndef BOARDVIEW_H
+#define BOARDVIEW_H
+
+#include "boardmodel.h"
+#include "celltiles.h"
+#include "probabilityengine.h"
+
+#include <QAbstractScrollArea>
+#include <QHash>
+#include <QPainter>
+#include <QSet>
+#include <QTimer>
+#include <QVector>
+
+#include <limits>
+
+class BoardView : public QAbstractScrollArea
+{
+    Q_OBJECT
+
+public:
+    // Sides up to MaximumSide cells keep the board's pixel size within an int at every zoom level.
+    enum
+    {
+        MaximumCellSize = 128,
+        MaximumSide = std::numeric_limits< int >::max() / MaximumCellSize
+    };
+    BoardView(const BoardModel &board, QWidget *parent = nullptr);
+
+    int cellSize() const;
+    void setCellSize(int size);
+    void resetBoard();
+
+    void refreshCell(int index);
+    void refreshCells(const std::vector< int > &indexes);
+    void refreshAll();
+    void setProgressiveReveal(bool enabled);
+    void finishReveal();
+    void setHighlighted(const QVector< int > &indexes, bool highlighted);
+    void setPeek(bool peek);
+    void setExploded(int index);
+    void setHeatMap(const ProbabilityEngine::Result &result, bool visible);
+
+    QSize sizeHint() const override;
+
+signals:
+    void cellClicked(int index, Qt::MouseButton button);
+
+protected:
+    void changeEvent(QEvent *event) override;
+    void paintEvent(QPaintEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void scrollContentsBy(int dx, int dy) override;
+
+private:
+    enum
+    {
+        MinimumCellSize = 8,
+        DefaultCellSize = 50,
+        MaximumSizeHint = 1000
+    };
+
+    // Openings of at least ProgressiveCells cells are shown over several frames, in the engine's breadth-first
+    // order, so they spread outward from the click: a slice of the cells every RevealInterval ms, at least
+    // MinimumRevealStep and enough to finish in about RevealFrames frames. A step is painted only after
+    // revealStep() returns, so when the previous paint took longer than RevealBudget ms the next step is
+    // scaled down by the same ratio instead.
+    enum
+    {
+        ProgressiveCells = 16384,
+        MinimumRevealStep = 4096,
+        RevealFrames = 12,
+        RevealInterval = 16,
+        RevealBudget = 8
+    };
+
+    void updateCells(const int *indexes, std::size_t count);
+    void revealStep();
+    int tileFor(int index) const;
+    void drawCell(QPainter &painter, int index, const QRect &rect) const;
+    QPoint boardOrigin() const;
+    QRect cellRect(int index) const;
+    int cellAt(const QPoint &pos) const;
+    void zoom(int size, const QPoint &anchor);
+    void fitToView();
+    void updateScrollBars();
+
+    const BoardModel &m_board;
+
+    int m_cellSize;
+    int m_exploded;
+
+    bool m_fitToView;
+    bool m_peek;
+    bool m_heatMapVisible;
+    bool m_progressive;
+
+    double m_interiorHeat;
+
+    QSet< int > m_highlighted;
+    QHash< int, double > m_heat;
+    CellTiles m_tiles;
+
+    // Cells the model has opened but the view still draws as hidden, and the order they will appear in.
+    std::vector< int > m_revealQueue;
+    std::size_t m_revealNext;
+    std::size_t m_revealStep;
+    qint64 m_paintTime;
+    std::vector< char > m_concealed;
+    QTimer m_revealTimer;
+};
+
+#endif	  // BOARDVIEW_H
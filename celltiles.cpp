@@ -0,0 +1,102 @@
+#include "celltiles.h"
+
+#include <QPainter>
+
+namespace
+{
+const QColor FlaggedColor(0, 0, 255);
+const QColor QuestionColor(173, 216, 230);
+const QColor OpenedColor(211, 211, 211);
+const QColor MineColor(255, 0, 0);
+const QColor ExplodedColor(139, 0, 0);
+}	 // namespace
+
+CellTiles::CellTiles() : m_cellSize(0), m_ratio(0) {}
+
+int CellTiles::tileFor(BoardModel::State state, bool mine, int adjacentMines, bool peek, bool exploded)
+{
+    switch (state)
+    {
+    case BoardModel::Hidden:
+        return peek && mine ? PeekTile : HiddenTile;
+    case BoardModel::Flagged:
+        return FlaggedTile;
+    case BoardModel::Question:
+        return QuestionTile;
+    case BoardModel::Opened:
+        break;
+    }
+    if (mine)
+        return exploded ? ExplodedTile : MineTile;
+    return OpenedTile + adjacentMines;
+}
+
+bool CellTiles::isValid(int cellSize, qreal ratio) const
+{
+    return m_cellSize == cellSize && m_ratio == ratio;
+}
+
+void CellTiles::build(int cellSize, qreal ratio, const QPalette &palette, QFont font)
+{
+    font.setPixelSize(qMax(6, cellSize / 2));
+    m_tiles.resize(TileCount);
+    for (int tile = 0; tile < TileCount; ++tile)
+    {
+        QColor background = palette.color(QPalette::Button);
+        QString text;
+        switch (tile)
+        {
+        case HiddenTile:
+            break;
+        case PeekTile:
+            text = "M";
+            break;
+        case FlaggedTile:
+            background = FlaggedColor;
+            text = "⚐";
+            break;
+        case QuestionTile:
+            background = QuestionColor;
+            text = "?";
+            break;
+        case MineTile:
+            background = MineColor;
+            text = "M";
+            break;
+        case ExplodedTile:
+            background = ExplodedColor;
+            text = "M";
+            break;
+        default:
+            background = OpenedColor;
+            if (tile > OpenedTile)
+                text = QString::number(tile - OpenedTile);
+            break;
+        }
+        QPixmap pixmap(QSize(cellSize, cellSize) * ratio);
+        pixmap.setDevicePixelRatio(ratio);
+        pixmap.fill(background);
+        QPainter painter(&pixmap);
+        painter.setPen(palette.color(QPalette::Mid));
+        painter.drawRect(0, 0, cellSize - 1, cellSize - 1);
+        if (!text.isEmpty())
+        {
+            painter.setFont(font);
+            painter.setPen(palette.color(QPalette::ButtonText));
+            painter.drawText(QRect(0, 0, cellSize, cellSize), Qt::AlignCenter, text);
+        }
+        m_tiles[tile] = pixmap;
+    }
+    m_cellSize = cellSize;
+    m_ratio = ratio;
+}
+
+void CellTiles::invalidate()
+{
+    m_cellSize = 0;
+}
+
+const QPixmap &CellTiles::tile(int tile) const
+{
+    return m_tiles[tile];
+}
@@ -0,0 +1,45 @@
+#ifndef CELLTILES_H
+#define CELLTILES_H
+
+#include "boardmodel.h"
+
+#include <QFont>
+#include <QPalette>
+#include <QPixmap>
+#include <QVector>
+
+// One prebuilt pixmap per visual cell state, so a view paints a cell with a single blit however many change at
+// once. Both BoardView and ChunkedBoardView draw from it, which keeps the two boards looking the same.
+class CellTiles
+{
+public:
+    // Opened cells take OpenedTile + their adjacent mine count.
+    enum Tile
+    {
+        HiddenTile,
+        PeekTile,
+        FlaggedTile,
+        QuestionTile,
+        MineTile,
+        ExplodedTile,
+        OpenedTile,
+        TileCount = OpenedTile + 9
+    };
+    CellTiles();
+
+    static int tileFor(BoardModel::State state, bool mine, int adjacentMines, bool peek, bool exploded);
+
+    // The tiles depend only on cell size, pixel ratio, palette and font; invalidate() after a palette or font change.
+    bool isValid(int cellSize, qreal ratio) const;
+    void build(int cellSize, qreal ratio, const QPalette &palette, QFont font);
+    void invalidate();
+
+    const QPixmap &tile(int tile) const;
+
+private:
+    int m_cellSize;
+    qreal m_ratio;
+    QVector< QPixmap > m_tiles;
+};
+
+#endif	  // CELLTILES_H
@@ -0,0 +1,453 @@
+#include "chunkedboard.h"
+
+#include "seededrandom.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+const int ChunkCells = ChunkedBoard::ChunkSize * ChunkedBoard::ChunkSize;
+const int PlaneSize = ChunkedBoard::ChunkSize + 2;
+const std::size_t DefaultChunkBudget = 4096;
+
+// floor(a * b / c) without 128-bit arithmetic, for a < c < 2^63; the result never exceeds b.
+std::uint64_t mulDiv(std::uint64_t a, std::uint64_t b, std::uint64_t c)
+{
+    std::uint64_t quotient = 0;
+    std::uint64_t remainder = 0;
+    for (int bit = 63; bit >= 0; --bit)
+    {
+        quotient <<= 1;
+        remainder <<= 1;
+        if (remainder >= c)
+        {
+            remainder -= c;
+            ++quotient;
+        }
+        if ((b >> bit) & 1)
+        {
+            remainder += a;
+            if (remainder >= c)
+            {
+                remainder -= c;
+                ++quotient;
+            }
+        }
+    }
+    return quotient;
+}
+}	 // namespace
+
+ChunkedBoard::ChunkedBoard() :
+    m_width(0), m_height(0), m_chunkRows(0), m_chunkCols(0), m_requestedMines(0), m_mineCount(0), m_flagCount(0), m_openedSafeCount(0), m_seed(0), m_safeRow(-1),
+    m_safeCol(-1), m_chunkBudget(DefaultChunkBudget), m_clock(0), m_lastKey(0), m_last(nullptr)
+{
+}
+
+void ChunkedBoard::reset(std::int64_t width, std::int64_t height, std::int64_t mines, std::uint64_t seed)
+{
+    m_width = width;
+    m_height = height;
+    m_chunkRows = (height + ChunkSize - 1) >> ChunkShift;
+    m_chunkCols = (width + ChunkSize - 1) >> ChunkShift;
+    m_requestedMines = mines;
+    m_mineCount = mines;
+    m_flagCount = 0;
+    m_openedSafeCount = 0;
+    m_seed = seed;
+    m_safeRow = -1;
+    m_safeCol = -1;
+    m_live.clear();
+    m_stored.clear();
+    m_last = nullptr;
+    m_frontier.clear();
+}
+
+void ChunkedBoard::setChunkBudget(std::size_t chunks)
+{
+    m_chunkBudget = std::max< std::size_t >(chunks, 16);
+    trim();
+}
+
+std::int64_t ChunkedBoard::width() const
+{
+    return m_width;
+}
+
+std::int64_t ChunkedBoard::height() const
+{
+    return m_height;
+}
+
+std::int64_t ChunkedBoard::cellCount() const
+{
+    return m_width * m_height;
+}
+
+bool ChunkedBoard::contains(std::int64_t row, std::int64_t col) const
+{
+    return row >= 0 && row < m_height && col >= 0 && col < m_width;
+}
+
+bool ChunkedBoard::isMine(std::int64_t row, std::int64_t col)
+{
+    return cell(row, col) & MineBit;
+}
+
+bool ChunkedBoard::isOpened(std::int64_t row, std::int64_t col)
+{
+    return state(row, col) == BoardModel::Opened;
+}
+
+int ChunkedBoard::adjacentMines(std::int64_t row, std::int64_t col)
+{
+    return cell(row, col) & AdjacentMask;
+}
+
+BoardModel::State ChunkedBoard::state(std::int64_t row, std::int64_t col)
+{
+    return static_cast< BoardModel::State >((cell(row, col) & StateMask) >> StateShift);
+}
+
+void ChunkedBoard::setState(std::int64_t row, std::int64_t col, BoardModel::State state)
+{
+    std::uint8_t &value = cell(row, col);
+    BoardModel::State previous = static_cast< BoardModel::State >((value & StateMask) >> StateShift);
+    if (previous == state)
+        return;
+    if (!(value & MineBit))
+    {
+        if (previous == BoardModel::Opened)
+            --m_openedSafeCount;
+        else if (state == BoardModel::Opened)
+            ++m_openedSafeCount;
+    }
+    if (previous == BoardModel::Flagged)
+        --m_flagCount;
+    else if (state == BoardModel::Flagged)
+        ++m_flagCount;
+    value = (value & ~StateMask) | (state << StateShift);
+}
+
+std::int64_t ChunkedBoard::mineCount() const
+{
+    return m_mineCount;
+}
+
+std::int64_t ChunkedBoard::flagCount() const
+{
+    return m_flagCount;
+}
+
+std::int64_t ChunkedBoard::openedSafeCount() const
+{
+    return m_openedSafeCount;
+}
+
+std::int64_t ChunkedBoard::remainingMines() const
+{
+    return m_mineCount - m_flagCount;
+}
+
+bool ChunkedBoard::isCleared() const
+{
+    return m_openedSafeCount == cellCount() - m_mineCount;
+}
+
+void ChunkedBoard::setSafeZone(std::int64_t row, std::int64_t col)
+{
+    // The first click and its neighbours become part of the hash's input rather than moving mines afterwards,
+    // so every chunk stays a pure function of (seed, safe cell). Chunks already built keep their cell states.
+    m_safeRow = row;
+    m_safeCol = col;
+    m_mineCount = m_requestedMines;
+    std::uint64_t rows[ChunkSize];
+    for (std::int64_t chunkRow = std::max< std::int64_t >(0, (row - 1) >> ChunkShift); chunkRow <= std::min(m_chunkRows - 1, (row + 1) >> ChunkShift); ++chunkRow)
+    {
+        for (std::int64_t chunkCol = std::max< std::int64_t >(0, (col - 1) >> ChunkShift); chunkCol <= std::min(m_chunkCols - 1, (col + 1) >> ChunkShift); ++chunkCol)
+        {
+            m_mineCount -= quota(chunkRow, chunkCol) - placeMines(chunkRow, chunkCol, rows);
+        }
+    }
+    for (auto &entry : m_live)
+    {
+        std::vector< std::uint8_t > states(ChunkCells);
+        for (int i = 0; i < ChunkCells; ++i)
+        {
+            states[i] = entry.second.cells[i] & StateMask;
+        }
+        build(static_cast< std::int64_t >(entry.first / m_chunkCols), static_cast< std::int64_t >(entry.first % m_chunkCols), entry.second);
+        for (int i = 0; i < ChunkCells; ++i)
+        {
+            entry.second.cells[i] |= states[i];
+        }
+    }
+}
+
+std::int64_t ChunkedBoard::openArea(std::int64_t row, std::int64_t col)
+{
+    std::int64_t before = m_openedSafeCount;
+    open(row, col);
+    flood();
+    return m_openedSafeCount - before;
+}
+
+std::int64_t ChunkedBoard::openNeighbours(std::int64_t row, std::int64_t col)
+{
+    // A chord; as with BoardModel::openNeighbours the caller has already checked that no neighbour is a mine.
+    std::int64_t before = m_openedSafeCount;
+    for (std::int64_t r = row - 1; r <= row + 1; ++r)
+    {
+        for (std::int64_t c = col - 1; c <= col + 1; ++c)
+        {
+            if ((r != row || c != col) && contains(r, c))
+                open(r, c);
+        }
+    }
+    flood();
+    return m_openedSafeCount - before;
+}
+
+bool ChunkedBoard::isFlooding() const
+{
+    return !m_frontier.empty();
+}
+
+std::int64_t ChunkedBoard::continueFlood()
+{
+    std::int64_t before = m_openedSafeCount;
+    flood();
+    return m_openedSafeCount - before;
+}
+
+std::size_t ChunkedBoard::liveChunks() const
+{
+    return m_live.size();
+}
+
+std::size_t ChunkedBoard::storedChunks() const
+{
+    return m_stored.size();
+}
+
+std::size_t ChunkedBoard::memoryUsage() const
+{
+    std::size_t bytes = m_live.size() * (sizeof(Chunk) + ChunkCells);
+    for (const auto &entry : m_stored)
+    {
+        bytes += sizeof(entry) + entry.second.capacity();
+    }
+    return bytes;
+}
+
+std::uint64_t ChunkedBoard::chunkKey(std::int64_t chunkRow, std::int64_t chunkCol) const
+{
+    return static_cast< std::uint64_t >(chunkRow * m_chunkCols + chunkCol);
+}
+
+std::uint8_t &ChunkedBoard::cell(std::int64_t row, std::int64_t col)
+{
+    return chunk(row >> ChunkShift, col >> ChunkShift).cells[((row & (ChunkSize - 1)) << ChunkShift) | (col & (ChunkSize - 1))];
+}
+
+ChunkedBoard::Chunk &ChunkedBoard::chunk(std::int64_t chunkRow, std::int64_t chunkCol)
+{
+    std::uint64_t key = chunkKey(chunkRow, chunkCol);
+    if (m_last && m_lastKey == key)
+        return *m_last;
+    auto found = m_live.find(key);
+    if (found == m_live.end())
+    {
+        // Nothing holds a reference into another chunk across this call, so this is the one safe place to evict.
+        trim();
+        found = m_live.emplace(key, Chunk()).first;
+        build(chunkRow, chunkCol, found->second);
+        auto stored = m_stored.find(key);
+        if (stored != m_stored.end())
+        {
+            // Runs of (length, state) pairs, one varint each: length * 4 + state.
+            std::uint8_t *cells = found->second.cells.data();
+            const std::vector< std::uint8_t > &runs = stored->second;
+            for (std::size_t i = 0; i < runs.size();)
+            {
+                std::uint64_t value = 0;
+                for (int shift = 0;; shift += 7)
+                {
+                    std::uint8_t byte = runs[i++];
+                    value |= std::uint64_t(byte & 0x7f) << shift;
+                    if (!(byte & 0x80))
+                        break;
+                }
+                std::uint8_t state = static_cast< std::uint8_t >((value & 3) << StateShift);
+                for (std::uint64_t k = value >> 2; k > 0; --k)
+                {
+                    *cells++ |= state;
+                }
+            }
+            m_stored.erase(stored);
+        }
+    }
+    found->second.used = ++m_clock;
+    m_lastKey = key;
+    m_last = &found->second;
+    return found->second;
+}
+
+std::int64_t ChunkedBoard::quota(std::int64_t chunkRow, std::int64_t chunkCol) const
+{
+    // Chunks in row-major order take consecutive slices of the board, and each gets the mines that fall in its
+    // slice of an even spread: exact per chunk, exact in total, and computable for any chunk on its own.
+    std::int64_t rows = std::min< std::int64_t >(ChunkSize, m_height - (chunkRow << ChunkShift));
+    std::int64_t cols = std::min< std::int64_t >(ChunkSize, m_width - (chunkCol << ChunkShift));
+    std::uint64_t begin = static_cast< std::uint64_t >((chunkRow << ChunkShift) * m_width + rows * (chunkCol << ChunkShift));
+    std::uint64_t end = begin + static_cast< std::uint64_t >(rows * cols);
+    std::uint64_t mines = static_cast< std::uint64_t >(m_requestedMines);
+    std::uint64_t cells = static_cast< std::uint64_t >(cellCount());
+    return static_cast< std::int64_t >(mulDiv(mines, end, cells) - mulDiv(mines, begin, cells));
+}
+
+int ChunkedBoard::placeMines(std::int64_t chunkRow, std::int64_t chunkCol, std::uint64_t *rows) const
+{
+    int chunkRows = static_cast< int >(std::min< std::int64_t >(ChunkSize, m_height - (chunkRow << ChunkShift)));
+    int chunkCols = static_cast< int >(std::min< std::int64_t >(ChunkSize, m_width - (chunkCol << ChunkShift)));
+    int candidates[ChunkCells];
+    int count = 0;
+    for (int r = 0; r < chunkRows; ++r)
+    {
+        rows[r] = 0;
+        std::int64_t row = (chunkRow << ChunkShift) + r;
+        for (int c = 0; c < chunkCols; ++c)
+        {
+            std::int64_t col = (chunkCol << ChunkShift) + c;
+            if (m_safeRow >= 0 && row >= m_safeRow - 1 && row <= m_safeRow + 1 && col >= m_safeCol - 1 && col <= m_safeCol + 1)
+                continue;
+            candidates[count++] = (r << ChunkShift) | c;
+        }
+    }
+    std::fill(rows + chunkRows, rows + ChunkSize, 0);
+    int mines = static_cast< int >(std::min< std::int64_t >(quota(chunkRow, chunkCol), count));
+    SeededRandom random(SeededRandom(m_seed ^ (chunkKey(chunkRow, chunkCol) * 0x9e3779b97f4a7c15ULL)).next());
+    for (int i = 0; i < mines; ++i)
+    {
+        std::swap(candidates[i], candidates[i + random.bounded(count - i)]);
+        rows[candidates[i] >> ChunkShift] |= std::uint64_t(1) << (candidates[i] & (ChunkSize - 1));
+    }
+    return mines;
+}
+
+void ChunkedBoard::build(std::int64_t chunkRow, std::int64_t chunkCol, Chunk &chunk) const
+{
+    // Adjacency needs the mines of the ring around the chunk, which the neighbouring chunks' hashes give
+    // without materialising them.
+    std::vector< std::uint8_t > plane(PlaneSize * PlaneSize, 0);
+    std::uint64_t rows[ChunkSize];
+    for (int dr = -1; dr <= 1; ++dr)
+    {
+        for (int dc = -1; dc <= 1; ++dc)
+        {
+            std::int64_t neighbourRow = chunkRow + dr;
+            std::int64_t neighbourCol = chunkCol + dc;
+            if (neighbourRow < 0 || neighbourRow >= m_chunkRows || neighbourCol < 0 || neighbourCol >= m_chunkCols)
+                continue;
+            placeMines(neighbourRow, neighbourCol, rows);
+            for (int r = 0; r < ChunkSize; ++r)
+            {
+                int planeRow = r + dr * ChunkSize + 1;
+                if (!rows[r] || planeRow < 0 || planeRow >= PlaneSize)
+                    continue;
+                for (int c = 0; c < ChunkSize; ++c)
+                {
+                    int planeCol = c + dc * ChunkSize + 1;
+                    if (planeCol >= 0 && planeCol < PlaneSize)
+                        plane[planeRow * PlaneSize + planeCol] = (rows[r] >> c) & 1;
+                }
+            }
+        }
+    }
+    chunk.cells.assign(ChunkCells, 0);
+    for (int r = 0; r < ChunkSize; ++r)
+    {
+        const std::uint8_t *above = plane.data() + r * PlaneSize;
+        const std::uint8_t *middle = above + PlaneSize;
+        const std::uint8_t *below = middle + PlaneSize;
+        std::uint8_t *cells = chunk.cells.data() + (r << ChunkShift);
+        for (int c = 0; c < ChunkSize; ++c)
+        {
+            int count = above[c] + above[c + 1] + above[c + 2] + middle[c] + middle[c + 2] + below[c] + below[c + 1] + below[c + 2];
+            cells[c] = static_cast< std::uint8_t >((middle[c + 1] ? MineBit : 0) | count);
+        }
+    }
+}
+
+void ChunkedBoard::open(std::int64_t row, std::int64_t col)
+{
+    std::uint8_t &value = cell(row, col);
+    if (value & StateMask)
+        return;
+    value |= BoardModel::Opened << StateShift;
+    ++m_openedSafeCount;
+    m_frontier.push_back(Cell { row, col });
+}
+
+void ChunkedBoard::flood()
+{
+    // Breadth-first like BoardModel::flood, but the queue only holds the frontier: an opening of millions of
+    // cells must not keep a list of all of them. Every click and chord feeds the same frontier.
+    for (int step = 0; step < FloodStep && !m_frontier.empty(); ++step)
+    {
+        Cell current = m_frontier.front();
+        m_frontier.pop_front();
+        if (cell(current.row, current.col) & AdjacentMask)
+            continue;
+        for (std::int64_t r = current.row - 1; r <= current.row + 1; ++r)
+        {
+            for (std::int64_t c = current.col - 1; c <= current.col + 1; ++c)
+            {
+                if (contains(r, c))
+                    open(r, c);
+            }
+        }
+    }
+}
+
+void ChunkedBoard::trim()
+{
+    if (m_live.size() < m_chunkBudget)
+        return;
+    // Evict in batches down to three quarters of the budget so the sort is paid once per many chunks.
+    std::vector< std::pair< std::uint64_t, std::uint64_t > > ages;
+    ages.reserve(m_live.size());
+    for (const auto &entry : m_live)
+    {
+        ages.emplace_back(entry.second.used, entry.first);
+    }
+    std::size_t evicted = m_live.size() - m_chunkBudget * 3 / 4;
+    std::nth_element(ages.begin(), ages.begin() + evicted, ages.end());
+    for (std::size_t i = 0; i < evicted; ++i)
+    {
+        const std::vector< std::uint8_t > &cells = m_live[ages[i].second].cells;
+        std::vector< std::uint8_t > runs;
+        bool touched = false;
+        for (int start = 0; start < ChunkCells;)
+        {
+            std::uint8_t state = cells[start] & StateMask;
+            int end = start + 1;
+            while (end < ChunkCells && (cells[end] & StateMask) == state)
+                ++end;
+            touched = touched || state != 0;
+            for (std::uint64_t value = std::uint64_t(end - start) * 4 + (state >> StateShift); value; value >>= 7)
+            {
+                runs.push_back(static_cast< std::uint8_t >((value & 0x7f) | (value >= 0x80 ? 0x80 : 0)));
+            }
+            start = end;
+        }
+        if (touched)
+        {
+            runs.shrink_to_fit();
+            m_stored[ages[i].second] = std::move(runs);
+        }
+        m_live.erase(ages[i].second);
+    }
+    m_last = nullptr;
+}
@@ -0,0 +1,112 @@
+#ifndef CHUNKEDBOARD_H
+#define CHUNKEDBOARD_H
+
+#include "boardmodel.h"
+
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+// A board too large to hold in memory. Mines come from a hash of (seed, chunk), so any 64x64 chunk can be
+// rebuilt at any time; only chunks the game has reached are materialised, and the least recently used ones
+// are evicted to a run-length delta of their cell states. Memory follows the explored area, not the board.
+class ChunkedBoard
+{
+public:
+    // An opening is flooded at most FloodStep cells at a time; the rest of its frontier stays queued for
+    // continueFlood(), so one click on a sparse map cannot try to open and materialise the whole board at once.
+    enum : int
+    {
+        ChunkShift = 6,
+        ChunkSize = 1 << ChunkShift,
+        FloodStep = 1 << 16
+    };
+    ChunkedBoard();
+
+    void reset(std::int64_t width, std::int64_t height, std::int64_t mines, std::uint64_t seed);
+    void setChunkBudget(std::size_t chunks);
+
+    std::int64_t width() const;
+    std::int64_t height() const;
+    std::int64_t cellCount() const;
+    bool contains(std::int64_t row, std::int64_t col) const;
+
+    bool isMine(std::int64_t row, std::int64_t col);
+    bool isOpened(std::int64_t row, std::int64_t col);
+    int adjacentMines(std::int64_t row, std::int64_t col);
+    BoardModel::State state(std::int64_t row, std::int64_t col);
+    void setState(std::int64_t row, std::int64_t col, BoardModel::State state);
+
+    std::int64_t mineCount() const;
+    std::int64_t flagCount() const;
+    std::int64_t openedSafeCount() const;
+    std::int64_t remainingMines() const;
+    bool isCleared() const;
+
+    void setSafeZone(std::int64_t row, std::int64_t col);
+    std::int64_t openArea(std::int64_t row, std::int64_t col);
+    std::int64_t openNeighbours(std::int64_t row, std::int64_t col);
+    bool isFlooding() const;
+    std::int64_t continueFlood();
+
+    std::size_t liveChunks() const;
+    std::size_t storedChunks() const;
+    std::size_t memoryUsage() const;
+
+private:
+    // Same byte layout as BoardModel: bits 0-3 adjacent mines, bit 4 mine, bits 5-6 state.
+    enum : std::uint8_t
+    {
+        AdjacentMask = 0x0f,
+        MineBit = 0x10,
+        StateShift = 5,
+        StateMask = 0x60
+    };
+
+    struct Chunk
+    {
+        std::vector< std::uint8_t > cells;
+        std::uint64_t used;
+    };
+
+    struct Cell
+    {
+        std::int64_t row;
+        std::int64_t col;
+    };
+
+    std::uint64_t chunkKey(std::int64_t chunkRow, std::int64_t chunkCol) const;
+    std::uint8_t &cell(std::int64_t row, std::int64_t col);
+    Chunk &chunk(std::int64_t chunkRow, std::int64_t chunkCol);
+    std::int64_t quota(std::int64_t chunkRow, std::int64_t chunkCol) const;
+    int placeMines(std::int64_t chunkRow, std::int64_t chunkCol, std::uint64_t *rows) const;
+    void build(std::int64_t chunkRow, std::int64_t chunkCol, Chunk &chunk) const;
+    void open(std::int64_t row, std::int64_t col);
+    void flood();
+    void trim();
+
+    std::int64_t m_width;
+    std::int64_t m_height;
+    std::int64_t m_chunkRows;
+    std::int64_t m_chunkCols;
+    std::int64_t m_requestedMines;
+    std::int64_t m_mineCount;
+    std::int64_t m_flagCount;
+    std::int64_t m_openedSafeCount;
+    std::uint64_t m_seed;
+    std::int64_t m_safeRow;
+    std::int64_t m_safeCol;
+    std::size_t m_chunkBudget;
+    std::uint64_t m_clock;
+
+    std::unordered_map< std::uint64_t, Chunk > m_live;
+    std::unordered_map< std::uint64_t, std::vector< std::uint8_t > > m_stored;
+    std::uint64_t m_lastKey;
+    Chunk *m_last;
+
+    // Opened cells whose neighbours have not been looked at yet.
+    std::deque< Cell > m_frontier;
+};
+
+#endif	  // CHUNKEDBOARD_H
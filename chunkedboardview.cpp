@@ -0,0 +1,112 @@
+#include "chunkedboardview.h"
+
+#include <QEvent>
+#include <QMouseEvent>
+#include <QScrollBar>
+
+#include <limits>
+
+ChunkedBoardView::ChunkedBoardView(ChunkedBoard &board, QWidget *parent) :
+    QAbstractScrollArea(parent), m_board(board), m_revealed(false), m_explodedRow(-1), m_explodedCol(-1)
+{
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    setFrameShape(QFrame::NoFrame);
+}
+
+void ChunkedBoardView::resetBoard()
+{
+    m_revealed = false;
+    m_explodedRow = -1;
+    m_explodedCol = -1;
+    updateScrollBars();
+    horizontalScrollBar()->setValue(horizontalScrollBar()->maximum() / 2);
+    verticalScrollBar()->setValue(verticalScrollBar()->maximum() / 2);
+    viewport()->update();
+}
+
+void ChunkedBoardView::refreshAll()
+{
+    viewport()->update();
+}
+
+void ChunkedBoardView::setRevealed(qint64 row, qint64 col)
+{
+    m_revealed = true;
+    m_explodedRow = row;
+    m_explodedCol = col;
+    viewport()->update();
+}
+
+QSize ChunkedBoardView::sizeHint() const
+{
+    return QSize(DefaultSizeHint, DefaultSizeHint);
+}
+
+void ChunkedBoardView::changeEvent(QEvent *event)
+{
+    if (event->type() == QEvent::PaletteChange || event->type() == QEvent::FontChange)
+        m_tiles.invalidate();
+    QAbstractScrollArea::changeEvent(event);
+}
+
+void ChunkedBoardView::paintEvent(QPaintEvent *event)
+{
+    if (!m_tiles.isValid(CellSize, devicePixelRatioF()))
+        m_tiles.build(CellSize, devicePixelRatioF(), palette(), font());
+    QPainter painter(viewport());
+    QRect area = event->rect();
+    painter.fillRect(area, palette().window());
+    qint64 top = verticalScrollBar()->value();
+    qint64 left = horizontalScrollBar()->value();
+    int lastRow = qMin< qint64 >(area.bottom() / CellSize, m_board.height() - 1 - top);
+    int lastCol = qMin< qint64 >(area.right() / CellSize, m_board.width() - 1 - left);
+    for (int row = area.top() / CellSize; row <= lastRow; ++row)
+    {
+        for (int col = area.left() / CellSize; col <= lastCol; ++col)
+        {
+            painter.drawPixmap(col * CellSize, row * CellSize, m_tiles.tile(tileFor(top + row, left + col)));
+        }
+    }
+}
+
+void ChunkedBoardView::mousePressEvent(QMouseEvent *event)
+{
+    qint64 row = verticalScrollBar()->value() + event->pos().y() / CellSize;
+    qint64 col = horizontalScrollBar()->value() + event->pos().x() / CellSize;
+    if (m_board.contains(row, col))
+        emit cellClicked(row, col, event->button());
+}
+
+void ChunkedBoardView::resizeEvent(QResizeEvent *event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    updateScrollBars();
+}
+
+void ChunkedBoardView::scrollContentsBy(int dx, int dy)
+{
+    viewport()->scroll(dx * CellSize, dy * CellSize);
+}
+
+int ChunkedBoardView::tileFor(qint64 row, qint64 col)
+{
+    // A lost game cannot open every mine of a board this size, so the mines in view are drawn as if it had.
+    BoardModel::State state = m_board.state(row, col);
+    bool mine = m_board.isMine(row, col);
+    if (m_revealed && mine && state != BoardModel::Flagged)
+        state = BoardModel::Opened;
+    return CellTiles::tileFor(state, mine, m_board.adjacentMines(row, col), false, row == m_explodedRow && col == m_explodedCol);
+}
+
+void ChunkedBoardView::updateScrollBars()
+{
+    int columns = viewport()->width() / CellSize;
+    int rows = viewport()->height() / CellSize;
+    qint64 maximum = std::numeric_limits< int >::max();
+    horizontalScrollBar()->setRange(0, int(qBound< qint64 >(0, m_board.width() - columns, maximum)));
+    horizontalScrollBar()->setPageStep(qMax(1, columns));
+    horizontalScrollBar()->setSingleStep(ScrollStep);
+    verticalScrollBar()->setRange(0, int(qBound< qint64 >(0, m_board.height() - rows, maximum)));
+    verticalScrollBar()->setPageStep(qMax(1, rows));
+    verticalScrollBar()->setSingleStep(ScrollStep);
+}
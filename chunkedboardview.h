@@ -0,0 +1,56 @@
+#ifndef CHUNKEDBOARDVIEW_H
+#define CHUNKEDBOARDVIEW_H
+
+#include "celltiles.h"
+#include "chunkedboard.h"
+
+#include <QAbstractScrollArea>
+#include <QPainter>
+
+// Paints the part of a ChunkedBoard under the viewport; asking for those cells is what builds their chunks.
+// Scroll bars count cells rather than pixels so boards billions of pixels wide stay within their int range.
+class ChunkedBoardView : public QAbstractScrollArea
+{
+    Q_OBJECT
+
+public:
+    ChunkedBoardView(ChunkedBoard &board, QWidget *parent = nullptr);
+
+    void resetBoard();
+    void refreshAll();
+    void setRevealed(qint64 row, qint64 col);
+
+    QSize sizeHint() const override;
+
+signals:
+    void cellClicked(qint64 row, qint64 col, Qt::MouseButton button);
+
+protected:
+    void changeEvent(QEvent *event) override;
+    void paintEvent(QPaintEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void scrollContentsBy(int dx, int dy) override;
+
+private:
+    enum
+    {
+        CellSize = 24,
+        ScrollStep = 3,
+        DefaultSizeHint = 800
+    };
+
+    int tileFor(qint64 row, qint64 col);
+    void updateScrollBars();
+
+    ChunkedBoard &m_board;
+
+    bool m_revealed;
+
+    CellTiles m_tiles;
+
+    qint64 m_explodedRow;
+    qint64 m_explodedCol;
+};
+
+#endif	  // CHUNKEDBOARDVIEW_H
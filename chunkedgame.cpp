@@ -0,0 +1,168 @@
+#include "chunkedgame.h"
+
+#include "gamerules.h"
+
+#include <vector>
+
+namespace
+{
+struct Cell
+{
+    qint64 row;
+    qint64 col;
+};
+
+// What GameRules needs from a board, with cells addressed by row and column.
+class Cells
+{
+public:
+    explicit Cells(ChunkedBoard &board) : board(board) {}
+
+    BoardModel::State state(Cell cell)
+    {
+        return board.state(cell.row, cell.col);
+    }
+    void setState(Cell cell, BoardModel::State state)
+    {
+        board.setState(cell.row, cell.col, state);
+    }
+    bool isMine(Cell cell)
+    {
+        return board.isMine(cell.row, cell.col);
+    }
+    int adjacentMines(Cell cell)
+    {
+        return board.adjacentMines(cell.row, cell.col);
+    }
+    qint64 remainingMines() const
+    {
+        return board.remainingMines();
+    }
+    int neighbours(Cell cell, Cell *out) const
+    {
+        int count = 0;
+        for (qint64 r = cell.row - 1; r <= cell.row + 1; ++r)
+        {
+            for (qint64 c = cell.col - 1; c <= cell.col + 1; ++c)
+            {
+                if ((r != cell.row || c != cell.col) && board.contains(r, c))
+                    out[count++] = Cell { r, c };
+            }
+        }
+        return count;
+    }
+
+private:
+    ChunkedBoard &board;
+};
+}	 // namespace
+
+ChunkedGame::ChunkedGame(ChunkedBoard &board, bool rus, QObject *parent) : QObject(parent), board(board), isRus(rus), isFirstMove(true), over(false)
+{
+    floodTimer.setSingleShot(true);
+    connect(&floodTimer, &QTimer::timeout, this, &ChunkedGame::floodStep);
+}
+
+bool ChunkedGame::isOver() const
+{
+    return over;
+}
+
+void ChunkedGame::handleCellClick(qint64 row, qint64 col, Qt::MouseButton button)
+{
+    if (over || !board.contains(row, col))
+        return;
+    if (button == Qt::LeftButton)
+    {
+        if (isFirstMove)
+        {
+            board.setSafeZone(row, col);
+            isFirstMove = false;
+            emit remainingMinesChanged();
+        }
+        Cells cells(board);
+        GameRules::Move move = GameRules::reveal(cells, Cell { row, col });
+        if (move == GameRules::Explode)
+        {
+            loseGame(row, col);
+        }
+        else if (move == GameRules::Open)
+        {
+            board.openArea(row, col);
+            opened();
+        }
+    }
+    else if (button == Qt::RightButton)
+    {
+        toggleFlagQuestion(row, col);
+    }
+    else if (button == Qt::MiddleButton)
+    {
+        middleClick(row, col);
+    }
+}
+
+void ChunkedGame::toggleFlagQuestion(qint64 row, qint64 col)
+{
+    Cells cells(board);
+    qint64 flags = board.flagCount();
+    if (!GameRules::mark(cells, Cell { row, col }))
+        return;
+    emit boardChanged();
+    if (board.flagCount() != flags)
+        emit remainingMinesChanged();
+}
+
+void ChunkedGame::middleClick(qint64 row, qint64 col)
+{
+    // The view has no highlight, so a chord that cannot open anything does nothing.
+    Cells cells(board);
+    Cell mine { -1, -1 };
+    std::vector< Cell > unopened;
+    GameRules::Move move = GameRules::chord(cells, Cell { row, col }, mine, unopened);
+    if (move == GameRules::Explode)
+    {
+        loseGame(mine.row, mine.col);
+    }
+    else if (move == GameRules::Open)
+    {
+        board.openNeighbours(row, col);
+        opened();
+    }
+}
+
+void ChunkedGame::opened()
+{
+    emit boardChanged();
+    checkWinCondition();
+    if (!over && board.isFlooding())
+        floodTimer.start(0);
+}
+
+void ChunkedGame::floodStep()
+{
+    if (over)
+        return;
+    board.continueFlood();
+    opened();
+}
+
+void ChunkedGame::loseGame(qint64 row, qint64 col)
+{
+    // Revealing every mine of a board this size is out of the question; the view shows the ones on screen.
+    over = true;
+    floodTimer.stop();
+    emit boardRevealed(row, col);
+    emit showMessage(":(", GameRules::lostMessage(isRus));
+}
+
+void ChunkedGame::checkWinCondition()
+{
+    if (board.isCleared())
+    {
+        over = true;
+        floodTimer.stop();
+        emit boardRevealed(-1, -1);
+        emit showMessage(":)", GameRules::wonMessage(isRus));
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef CHUNKEDGAME_H
+#define CHUNKEDGAME_H
+
+#include "chunkedboard.h"
+
+#include <QObject>
+#include <QTimer>
+
+// The rules of GameLogic (GameRules) for a ChunkedBoard: a safe first opening, flags and question marks,
+// chords. There is no solver, heat map or journal; those need the whole board in memory. Large openings are
+// flooded a step per event loop pass, so the window keeps painting and taking clicks while they spread.
+class ChunkedGame : public QObject
+{
+    Q_OBJECT
+
+public:
+    ChunkedGame(ChunkedBoard &board, bool rus, QObject *parent = nullptr);
+
+    bool isOver() const;
+    void handleCellClick(qint64 row, qint64 col, Qt::MouseButton button);
+
+signals:
+    void showMessage(const QString &message1, const QString &message2);
+    void boardChanged();
+    void remainingMinesChanged();
+    void boardRevealed(qint64 row, qint64 col);
+
+private:
+    void toggleFlagQuestion(qint64 row, qint64 col);
+    void middleClick(qint64 row, qint64 col);
+    void opened();
+    void floodStep();
+    void loseGame(qint64 row, qint64 col);
+    void checkWinCondition();
+
+    ChunkedBoard &board;
+    QTimer floodTimer;
+
+    bool isRus;
+    bool isFirstMove;
+    bool over;
+};
+
+#endif	  // CHUNKEDGAME_H
@@ -1,19 +1,30 @@
 #include "gamelogic.h"
 
-#include <QPair>
-#include <QRandomGenerator>
-#include <QSet>
+#include "gamerules.h"
+#include "latency.h"
+
 #include <QTimer>
-#include <QWidget>
 
-GameLogic::GameLogic(bool &changeDbg, bool &leftHanded, bool &firstMove, bool &rus, int &currentWidth, int &currentHeight, int &remaining, QGridLayout *gameGrid, QObject *parent) :
-    QObject(parent), changeDbg(changeDbg), isLeftHandedMode(leftHanded), isFirstMove(firstMove), isRus(rus),
-    currentWidth(currentWidth), currentHeight(currentHeight), remainingMines(remaining), gameGridLayout(gameGrid)
+GameLogic::GameLogic(bool &changeDbg, bool &leftHanded, bool &safeOpening, bool &noGuess, bool &firstMove, bool &rus, quint64 &seed, BoardModel &board, QObject *parent) :
+    QObject(parent), changeDbg(changeDbg), isLeftHandedMode(leftHanded), isSafeOpening(safeOpening), isNoGuess(noGuess), isFirstMove(firstMove), isRus(rus),
+    mineSeed(seed), board(board), solver(board), probabilities(board),
+    heatMapVisible(false), generatedStart(-1), generated(false), generating(false), generationId(0), transactionDepth(0), minesChanged(false), revealed(false),
+    explodedCell(-1)
 {
+    solver.reset();
 }
 
-void GameLogic::handleCellClick(Cell *cell, Qt::MouseButton button)
+GameLogic::~GameLogic()
 {
+    cancelGeneration();
+}
+
+void GameLogic::handleCellClick(int index, Qt::MouseButton button)
+{
+    Latency::Scope timing(Latency::CellClick);
+    // A finished board ignores clicks, so they are not journaled or recorded either.
+    if (generating || isOver())
+        return;
     if (isLeftHandedMode)
     {
         if (button == Qt::LeftButton)
@@ -25,304 +36,332 @@ void GameLogic::handleCellClick(Cell *cell, Qt::MouseButton button)
             button = Qt::LeftButton;
         }
     }
+    emit moveMade(index, button);
+    playMove(index, button);
+}
+
+void GameLogic::playMove(int index, Qt::MouseButton button)
+{
+    // Recorded moves already carry the left-handed swap; NoButton stands for a safe-opening toggle.
+    if (button == Qt::NoButton)
+    {
+        isSafeOpening = !isSafeOpening;
+        return;
+    }
+    beginTransaction();
+    applyMove(index, button);
+    endTransaction();
+    if (heatMapVisible)
+    {
+        updateHeatMap();
+    }
+}
+
+void GameLogic::toggleSafeOpening()
+{
+    // Recorded like a move, so replays see the setting the first click actually used.
+    if (!isOver())
+        emit moveMade(0, Qt::NoButton);
+    playMove(0, Qt::NoButton);
+}
+
+void GameLogic::applyMove(int index, Qt::MouseButton button)
+{
     if (button == Qt::LeftButton)
     {
         if (isFirstMove)
         {
-            if (cell->isMine())
+            if (board.isMine(index) || isSafeOpening)
             {
-                placeMineSafely(cell);
+                placeMineSafely(index);
             }
             isFirstMove = false;
         }
-        if (cell->currentState() == Cell::Hidden)
+        GameRules::Move move = GameRules::reveal(board, index);
+        if (move == GameRules::Explode)
         {
-            if (cell->isMine())
-            {
-                revealAllCells(cell);
-                QString message = "You lost!";
-                if (isRus)
-                {
-                    message = "Вы проиграли!";
-                }
-                emit showMessage(":(", message);
-            }
-            else
-            {
-                cell->open();
-                if (cell->adjacentMines() == 0)
-                {
-                    openAdjacentCells(cell);
-                }
-                checkWinCondition();
-            }
+            loseGame(index);
+        }
+        else if (move == GameRules::Open)
+        {
+            openAdjacentCells(index);
+            checkWinCondition();
         }
     }
     else if (button == Qt::RightButton)
     {
-        if (remainingMines == 0 && cell->currentState() == Cell::Hidden)
-        {
-            cell->toggleFlagQuestion();
-        }
-        cell->toggleFlagQuestion();
+        toggleFlagQuestion(index);
     }
     else if (button == Qt::MiddleButton)
     {
-        middleClick(cell);
+        middleClick(index);
     }
 }
 
-void GameLogic::middleClick(Cell *cell)
+void GameLogic::middleClick(int index)
 {
-    int row = cell->row();
-    int col = cell->col();
-    int flagged = 0;
-    int unopened = 0;
-    QVector< Cell * > adjacent;
-    for (int i = -1; i <= 1; ++i)
+    int hitMine = -1;
+    std::vector< int > unopened;
+    GameRules::Move move = GameRules::chord(board, index, hitMine, unopened);
+    if (move == GameRules::Explode)
     {
-        for (int j = -1; j <= 1; ++j)
-        {
-            if (i == 0 && j == 0)
-                continue;
-            int newRow = row + i;
-            int newCol = col + j;
-            if (newRow >= 1 && newRow <= gameGridLayout->rowCount() - 1 && newCol >= 0 && newCol < gameGridLayout->columnCount())
-            {
-                QWidget *widget = gameGridLayout->itemAtPosition(newRow, newCol)->widget();
-                if (Cell *adjCell = qobject_cast< Cell * >(widget))
-                {
-                    if (!adjCell->isOpened())
-                    {
-                        unopened++;
-                        adjacent.push_back(adjCell);
-                        if (adjCell->currentState() == Cell::Flagged)
-                        {
-                            flagged++;
-                        }
-                    }
-                }
-            }
-        }
+        // The whole chord is one move: a wrong flag loses at once, otherwise every neighbour opens in a
+        // single fill and the win check runs once.
+        loseGame(hitMine);
     }
-    if (flagged == cell->adjacentMines())
+    else if (move == GameRules::Open)
     {
-        for (Cell *adjCell : adjacent)
+        std::vector< int > opened;
         {
-            if (adjCell->currentState() != Cell::Flagged)
-            {
-                if (isLeftHandedMode)
-                    handleCellClick(adjCell, Qt::RightButton);
-                else
-                    handleCellClick(adjCell, Qt::LeftButton);
-            }
+            Latency::Scope timing(Latency::FloodFill);
+            opened = board.openNeighbours(index);
         }
+        cellsOpened(opened);
+        checkWinCondition();
     }
-    else if (unopened > 0)
+    else if (move == GameRules::Highlight)
     {
-        for (Cell *adjCell : adjacent)
-        {
-            if (adjCell->currentState() == Cell::Hidden)
-                adjCell->setStyleSheet("border: 2px solid yellow");
-        }
-        QTimer::singleShot(
-            1000,
-            this,
-            [adjacent]()
+        QVector< int > adjacent(unopened.begin(), unopened.end());
+        emit cellsHighlighted(adjacent, true);
+        QTimer::singleShot(1000, this, [this, adjacent]() { emit cellsHighlighted(adjacent, false); });
+    }
+}
+
+void GameLogic::placeMines(int mines)
+{
+    cancelGeneration();
+    if (isNoGuess)
+    {
+        // The search may take seconds, so it runs off the GUI thread; clicks are ignored until boardReady,
+        // which only this path emits.
+        generator.reset(new NoGuessGenerator(board.width(), board.height(), mines));
+        generating = true;
+        quint64 id = ++generationId;
+        quint64 seed = mineSeed;
+        generatorThread = std::thread(
+            [this, id, seed, mines]()
             {
-                for (Cell *adjCell : adjacent)
-                {
-                    if (adjCell->currentState() == Cell::Hidden)
-                        adjCell->setStyleSheet("color: black;");
-                }
+                generated = generator->generate(seed, generatedBoard, generatedStart);
+                QMetaObject::invokeMethod(this, [this, id, mines]() { finishGeneration(id, mines); }, Qt::QueuedConnection);
             });
+        return;
     }
+    board.placeMines(mines, mineSeed);
+    board.calculateAdjacentMines();
+    startGame(-1);
 }
 
-void GameLogic::placeMines(int width, int height, int mines)
+bool GameLogic::isGenerating() const
 {
-    QSet< QPair< int, int > > minePositions;
-    while (minePositions.size() < mines)
+    return generating;
+}
+
+bool GameLogic::isOver() const
+{
+    // Winning clears the board, and losing opens every cell, which clears it as well.
+    return board.isCleared();
+}
+
+void GameLogic::finishGeneration(quint64 id, int mines)
+{
+    // A result queued just before a newer game cancelled its search belongs to the old game.
+    if (id != generationId || !generatorThread.joinable())
+        return;
+    generatorThread.join();
+    generating = false;
+    if (generated)
     {
-        minePositions.insert(
-            qMakePair(QRandomGenerator::global()->bounded(1, height + 1), QRandomGenerator::global()->bounded(0, width)));
+        board = std::move(generatedBoard);
+        startGame(generatedStart);
+        emit boardReady();
+        return;
     }
-    for (auto pos : minePositions)
+    board.placeMines(mines, mineSeed);
+    board.calculateAdjacentMines();
+    startGame(-1);
+    emit boardReady();
+    QString message = "Could not build a no-guess board, this one may need guessing!";
+    if (isRus)
     {
-        QWidget *widget = gameGridLayout->itemAtPosition(pos.first, pos.second)->widget();
-        if (Cell *cell = qobject_cast< Cell * >(widget))
-        {
-            cell->setMine(true);
-        }
+        message = "Не удалось построить поле без угадывания, здесь может понадобиться угадывать!";
     }
-    isFirstMove = true;
+    postMessage("!", message);
 }
 
-void GameLogic::placeMineSafely(Cell *firstClickedCell)
+void GameLogic::cancelGeneration()
 {
-    bool relocated = false;
-    for (int row = 1; row <= currentHeight && !relocated; ++row)
-    {
-        for (int col = 0; col < currentWidth && !relocated; ++col)
-        {
-            Cell *cell = qobject_cast< Cell * >(gameGridLayout->itemAtPosition(row, col)->widget());
-            if (cell && !cell->isMine() && cell != firstClickedCell)
-            {
-                firstClickedCell->setMine(false);
-                cell->setMine(true);
-                relocated = true;
-            }
-        }
-    }
-    calculateAdjacentMines(currentWidth, currentHeight);
+    if (!generatorThread.joinable())
+        return;
+    generator->cancel();
+    generatorThread.join();
+    generating = false;
+    ++generationId;
 }
 
-void GameLogic::calculateAdjacentMines(int width, int height)
+void GameLogic::startGame(int start)
 {
-    for (int row = 1; row <= height; ++row)
+    cancelGeneration();
+    solver.reset();
+    isFirstMove = start < 0;
+    if (start >= 0)
     {
-        for (int col = 0; col < width; ++col)
-        {
-            Cell *cell = qobject_cast< Cell * >(gameGridLayout->itemAtPosition(row, col)->widget());
-            if (!cell || cell->isMine())
-                continue;
-            int mineCount = 0;
-            for (int i = -1; i <= 1; ++i)
-            {
-                for (int j = -1; j <= 1; ++j)
-                {
-                    if (i == 0 && j == 0)
-                        continue;
-                    int newRow = row + i;
-                    int newCol = col + j;
-                    if (newRow >= 1 && newRow <= height && newCol >= 0 && newCol < width)
-                    {
-                        Cell *adjCell = qobject_cast< Cell * >(gameGridLayout->itemAtPosition(newRow, newCol)->widget());
-                        if (adjCell && adjCell->isMine())
-                        {
-                            ++mineCount;
-                        }
-                    }
-                }
-            }
-            cell->setAdjacentMines(mineCount);
-        }
+        openAdjacentCells(start);
+    }
+    if (heatMapVisible)
+    {
+        updateHeatMap();
     }
 }
 
-void GameLogic::openAdjacentCells(Cell *cell)
+void GameLogic::placeMineSafely(int firstClicked)
 {
-    cell->open();
-    if (cell->adjacentMines() > 0)
+    board.clearSafeZone(firstClicked, isSafeOpening, ~mineSeed);
+}
+
+void GameLogic::openAdjacentCells(int index)
+{
+    std::vector< int > opened;
     {
-        return;
+        Latency::Scope timing(Latency::FloodFill);
+        opened = board.openArea(index);
     }
-    int row = cell->row();
-    int col = cell->col();
-    for (int i = -1; i <= 1; ++i)
+    cellsOpened(opened);
+}
+
+void GameLogic::cellsOpened(const std::vector< int > &opened)
+{
+    if (!opened.empty())
     {
-        for (int j = -1; j <= 1; ++j)
-        {
-            if (i == 0 && j == 0)
-                continue;
-            int newRow = row + i;
-            int newCol = col + j;
-            if (newRow >= 1 && newRow <= gameGridLayout->rowCount() - 1 && newCol >= 0 && newCol < gameGridLayout->columnCount())
-            {
-                QWidget *widget = gameGridLayout->itemAtPosition(newRow, newCol)->widget();
-                if (Cell *adjCell = qobject_cast< Cell * >(widget))
-                {
-                    if (!adjCell->isOpened() && adjCell->currentState() == Cell::Hidden)
-                    {
-                        openAdjacentCells(adjCell);
-                    }
-                }
-            }
-        }
+        solver.addOpened(opened);
+        changedCells.insert(changedCells.end(), opened.begin(), opened.end());
+        commit();
     }
 }
 
-void GameLogic::revealAllCells(Cell *clickedMine)
+void GameLogic::loseGame(int clickedMine)
 {
-    for (int row = 1; row <= gameGridLayout->rowCount() - 1; ++row)
+    revealAllCells(clickedMine);
+    postMessage(":(", GameRules::lostMessage(isRus));
+}
+
+void GameLogic::revealAllCells(int clickedMine)
+{
+    minesChanged = minesChanged || board.flagCount() > 0;
+    board.openAll();
+    revealed = true;
+    explodedCell = clickedMine;
+    commit();
+}
+
+void GameLogic::revealSilently()
+{
+    if (isFirstMove)
+        return;
+    emit peekChanged(changeDbg);
+}
+
+void GameLogic::checkWinCondition()
+{
+    Latency::Scope timing(Latency::WinCheck);
+    if (board.isCleared())
     {
-        for (int col = 0; col < gameGridLayout->columnCount(); ++col)
-        {
-            QWidget *widget = gameGridLayout->itemAtPosition(row, col)->widget();
-            if (Cell *cell = qobject_cast< Cell * >(widget))
-            {
-                cell->removeFlagQuestion();
-                if (cell->isMine())
-                {
-                    cell->open();
-                    if (cell == clickedMine)
-                    {
-                        cell->setStyleSheet("background-color: darkred");
-                    }
-                }
-                else
-                {
-                    cell->open();
-                }
-                cell->setEnabled(false);
-            }
-        }
+        revealAllCells();
+        postMessage(":)", GameRules::wonMessage(isRus));
     }
 }
 
-void GameLogic::revealSilently()
+void GameLogic::showHint()
 {
-    for (int row = 1; row <= gameGridLayout->rowCount() - 1; ++row)
+    if (isFirstMove || generating)
+        return;
+    Solver::Result result = solver.solve();
+    QVector< int > safe(result.safe.begin(), result.safe.end());
+    if (safe.isEmpty())
     {
-        for (int col = 0; col < gameGridLayout->columnCount(); ++col)
+        QString message = "No safe move found!";
+        if (isRus)
         {
-            QWidget *widget = gameGridLayout->itemAtPosition(row, col)->widget();
-            if (Cell *cell = qobject_cast< Cell * >(widget))
-            {
-                if (!isFirstMove && cell->isMine() && cell->currentState() == Cell::Hidden)
-                {
-                    if (changeDbg)
-                        cell->setText("M");
-                    else
-                        cell->setText(" ");
-                }
-            }
+            message = "Безопасный ход не найден!";
         }
+        postMessage("?", message);
+        return;
     }
+    emit cellsHighlighted(safe, true);
+    QTimer::singleShot(1000, this, [this, safe]() { emit cellsHighlighted(safe, false); });
 }
 
-void GameLogic::checkWinCondition()
+void GameLogic::toggleHeatMap()
 {
-    int openedCells = 0;
-    int totalCells = 0;
-    int mineCount = 0;
-    for (int row = 1; row <= gameGridLayout->rowCount() - 1; ++row)
+    heatMapVisible = !heatMapVisible;
+    updateHeatMap();
+}
+
+void GameLogic::updateHeatMap()
+{
+    if (!heatMapVisible || isFirstMove)
     {
-        for (int col = 0; col < gameGridLayout->columnCount(); ++col)
-        {
-            QWidget *widget = gameGridLayout->itemAtPosition(row, col)->widget();
-            if (Cell *cell = qobject_cast< Cell * >(widget))
-            {
-                totalCells++;
-                if (cell->isMine())
-                {
-                    mineCount++;
-                }
-                else if (cell->isOpened())
-                {
-                    openedCells++;
-                }
-            }
-        }
+        emit heatMapChanged(ProbabilityEngine::Result(), heatMapVisible && !isFirstMove);
+        return;
     }
-    if (openedCells == totalCells - mineCount)
+    emit heatMapChanged(probabilities.compute(), true);
+}
+
+void GameLogic::toggleFlagQuestion(int index)
+{
+    int flags = board.flagCount();
+    if (!GameRules::mark(board, index))
+        return;
+    changedCells.push_back(index);
+    minesChanged = minesChanged || board.flagCount() != flags;
+    commit();
+}
+
+void GameLogic::beginTransaction()
+{
+    ++transactionDepth;
+}
+
+void GameLogic::endTransaction()
+{
+    --transactionDepth;
+    commit();
+}
+
+void GameLogic::discardMessage()
+{
+    messageTitle.clear();
+    messageText.clear();
+}
+
+void GameLogic::postMessage(const QString &title, const QString &message)
+{
+    messageTitle = title;
+    messageText = message;
+    commit();
+}
+
+void GameLogic::commit()
+{
+    // Inside a transaction changes only accumulate. The outermost end reports them once: a single repaint request,
+    // at most one counter update, and any message last, so the final board is on screen before a dialog blocks.
+    if (transactionDepth > 0)
+        return;
+    if (revealed)
+        emit boardRevealed(explodedCell);
+    else if (!changedCells.empty())
+        emit cellsChanged(changedCells);
+    if (minesChanged)
+        emit remainingMinesChanged();
+    changedCells.clear();
+    minesChanged = false;
+    revealed = false;
+    explodedCell = -1;
+    if (!messageTitle.isEmpty())
     {
-        revealAllCells();
-        QString message = "You won!";
-        if (isRus)
-        {
-            message = "Вы выиграли!";
-        }
-        emit showMessage(":)", message);
+        QString title = messageTitle;
+        QString message = messageText;
+        messageTitle.clear();
+        messageText.clear();
+        emit showMessage(title, message);
     }
 }
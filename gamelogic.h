@@ -1,42 +1,98 @@
 #ifndef GAMELOGIC_H
 #define GAMELOGIC_H
 
-#include "cell.h"
+#include "boardmodel.h"
+#include "noguessgenerator.h"
+#include "probabilityengine.h"
+#include "solver.h"
 
-#include <QGridLayout>
 #include <QObject>
+#include <QVector>
+
+#include <memory>
+#include <thread>
 
 class GameLogic : public QObject
 {
     Q_OBJECT
 
 public:
-    GameLogic(bool &changeDbg, bool &leftHanded, bool &firstMove, bool &rus, int &currentWidth, int &currentHeight, int &remaining, QGridLayout *gameGrid, QObject *parent = nullptr);
-
-    void handleCellClick(Cell *cell, Qt::MouseButton button);
-    void middleClick(Cell *cell);
-    void placeMines(int width, int height, int mines);
-    void placeMineSafely(Cell *firstClickedCell);
-    void calculateAdjacentMines(int width, int height);
-    void openAdjacentCells(Cell *cell);
-    void revealAllCells(Cell *clickedMine = nullptr);
+    GameLogic(bool &changeDbg, bool &leftHanded, bool &safeOpening, bool &noGuess, bool &firstMove, bool &rus, quint64 &seed, BoardModel &board, QObject *parent = nullptr);
+    ~GameLogic();
+
+    void handleCellClick(int index, Qt::MouseButton button);
+    void playMove(int index, Qt::MouseButton button);
+    void toggleSafeOpening();
+    void applyMove(int index, Qt::MouseButton button);
+    void middleClick(int index);
+    void placeMines(int mines);
+    bool isGenerating() const;
+    bool isOver() const;
+    void startGame(int start);
+    void placeMineSafely(int firstClicked);
+    void openAdjacentCells(int index);
+    void revealAllCells(int clickedMine = -1);
     void revealSilently();
     void checkWinCondition();
+    void showHint();
+    void toggleHeatMap();
+    void beginTransaction();
+    void endTransaction();
+    void discardMessage();
 
 signals:
     void showMessage(const QString &message1, const QString &message2);
+    void moveMade(int index, Qt::MouseButton button);
+    void cellsChanged(const std::vector< int > &indexes);
+    void cellsHighlighted(const QVector< int > &indexes, bool highlighted);
+    void peekChanged(bool peek);
+    void remainingMinesChanged();
+    void boardRevealed(int clickedMine);
+    void boardReady();
+    void heatMapChanged(const ProbabilityEngine::Result &result, bool visible);
 
 private:
+    void toggleFlagQuestion(int index);
+    void cellsOpened(const std::vector< int > &opened);
+    void loseGame(int clickedMine);
+    void updateHeatMap();
+    void finishGeneration(quint64 id, int mines);
+    void cancelGeneration();
+    void postMessage(const QString &title, const QString &message);
+    void commit();
+
     bool &changeDbg;
     bool &isLeftHandedMode;
+    bool &isSafeOpening;
+    bool &isNoGuess;
     bool &isFirstMove;
     bool &isRus;
 
-    int &currentWidth;
-    int &currentHeight;
-    int &remainingMines;
+    quint64 &mineSeed;
+
+    BoardModel &board;
+    Solver solver;
+    ProbabilityEngine probabilities;
+
+    bool heatMapVisible;
+
+    // A no-guess search runs on generatorThread into generatedBoard; the board stays empty until it reports back.
+    std::unique_ptr< NoGuessGenerator > generator;
+    std::thread generatorThread;
+    BoardModel generatedBoard;
+    int generatedStart;
+    bool generated;
+    bool generating;
+    quint64 generationId;
 
-    QGridLayout *gameGridLayout;
+    // Changes recorded while a transaction is open, reported once by commit().
+    int transactionDepth;
+    std::vector< int > changedCells;
+    bool minesChanged;
+    bool revealed;
+    int explodedCell;
+    QString messageTitle;
+    QString messageText;
 };
 
 #endif	  // GAMELOGIC_H
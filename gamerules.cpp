@@ -0,0 +1,11 @@
+#include "gamerules.h"
+
+QString GameRules::lostMessage(bool rus)
+{
+    return rus ? "Вы проиграли!" : "You lost!";
+}
+
+QString GameRules::wonMessage(bool rus)
+{
+    return rus ? "Вы выиграли!" : "You won!";
+}
@@ -0,0 +1,95 @@
+#ifndef GAMERULES_H
+#define GAMERULES_H
+
+#include "boardmodel.h"
+
+#include <QString>
+
+#include <vector>
+
+// The rules GameLogic and ChunkedGame share, written once over the few board calls both boards offer:
+// state, setState, isMine, adjacentMines, remainingMines and neighbours(cell, out) -> count.
+// Cell is whatever the board addresses cells by. What a move then does (opening, losing, reporting)
+// stays with the caller.
+class GameRules
+{
+public:
+    enum Move
+    {
+        Ignore,
+        Open,
+        Explode,
+        Highlight
+    };
+
+    // A left click on a cell: only hidden cells react, and a mine explodes.
+    template< typename Board, typename Cell >
+    static Move reveal(Board &board, Cell cell)
+    {
+        if (board.state(cell) != BoardModel::Hidden)
+            return Ignore;
+        return board.isMine(cell) ? Explode : Open;
+    }
+
+    // A right click: Hidden -> Flagged -> Question -> Hidden. With every flag already placed a hidden cell
+    // goes straight to Question. Returns whether the cell changed.
+    template< typename Board, typename Cell >
+    static bool mark(Board &board, Cell cell)
+    {
+        switch (board.state(cell))
+        {
+        case BoardModel::Opened:
+            return false;
+        case BoardModel::Hidden:
+            board.setState(cell, board.remainingMines() == 0 ? BoardModel::Question : BoardModel::Flagged);
+            return true;
+        case BoardModel::Flagged:
+            board.setState(cell, BoardModel::Question);
+            return true;
+        case BoardModel::Question:
+            board.setState(cell, BoardModel::Hidden);
+            return true;
+        }
+        return false;
+    }
+
+    // A middle click on an opened number; any other cell is ignored, since comparing the flags with the count
+    // of a cell the player cannot see would give it away. With as many flags around the cell as it has mine
+    // neighbours the chord opens the other neighbours, or explodes on the first hidden mine among them (a
+    // wrong flag), stored in mine. Otherwise the unopened neighbours are collected for a brief highlight.
+    template< typename Board, typename Cell >
+    static Move chord(Board &board, Cell cell, Cell &mine, std::vector< Cell > &unopened)
+    {
+        unopened.clear();
+        if (board.state(cell) != BoardModel::Opened || board.adjacentMines(cell) == 0)
+            return Ignore;
+        Cell neighbours[8];
+        int count = board.neighbours(cell, neighbours);
+        int flagged = 0;
+        bool hit = false;
+        for (int k = 0; k < count; ++k)
+        {
+            BoardModel::State state = board.state(neighbours[k]);
+            if (state == BoardModel::Opened)
+                continue;
+            unopened.push_back(neighbours[k]);
+            if (state == BoardModel::Flagged)
+            {
+                ++flagged;
+            }
+            else if (!hit && state == BoardModel::Hidden && board.isMine(neighbours[k]))
+            {
+                mine = neighbours[k];
+                hit = true;
+            }
+        }
+        if (flagged == board.adjacentMines(cell))
+            return hit ? Explode : Open;
+        return unopened.empty() ? Ignore : Highlight;
+    }
+
+    static QString lostMessage(bool rus);
+    static QString wonMessage(bool rus);
+};
+
+#endif	  // GAMERULES_H
@@ -0,0 +1,104 @@
+#include "latency.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace
+{
+// Values below 8 ns have a bucket each; above that, bucket = 8 * (msb - 2) + the three bits after the msb.
+const int SubBuckets = 8;
+const int BucketCount = SubBuckets * 62;
+
+std::uint64_t histograms[Latency::ProbeCount][BucketCount];
+std::uint64_t maxima[Latency::ProbeCount];
+
+int bucketOf(std::uint64_t value)
+{
+    if (value < SubBuckets)
+        return static_cast< int >(value);
+    int msb = 63;
+    while (!(value >> msb))
+        --msb;
+    return (msb - 2) * SubBuckets + static_cast< int >((value >> (msb - 3)) & (SubBuckets - 1));
+}
+
+double bucketMiddle(int bucket)
+{
+    if (bucket < SubBuckets)
+        return bucket;
+    int shift = bucket / SubBuckets - 1;
+    double lower = double(SubBuckets + bucket % SubBuckets) * double(std::uint64_t(1) << shift);
+    return lower + double(std::uint64_t(1) << shift) / 2;
+}
+
+double percentile(const std::uint64_t *histogram, std::uint64_t count, double fraction)
+{
+    std::uint64_t rank = std::max< std::uint64_t >(1, static_cast< std::uint64_t >(fraction * count + 0.5));
+    std::uint64_t seen = 0;
+    for (int bucket = 0; bucket < BucketCount; ++bucket)
+    {
+        seen += histogram[bucket];
+        if (seen >= rank)
+            return bucketMiddle(bucket);
+    }
+    return 0;
+}
+}	 // namespace
+
+bool Latency::s_enabled = false;
+
+void Latency::setEnabled(bool enabled)
+{
+    s_enabled = enabled;
+}
+
+void Latency::record(Probe probe, std::uint64_t nanoseconds)
+{
+    ++histograms[probe][bucketOf(nanoseconds)];
+    maxima[probe] = std::max(maxima[probe], nanoseconds);
+}
+
+Latency::Summary Latency::summary(Probe probe)
+{
+    Summary summary;
+    for (int bucket = 0; bucket < BucketCount; ++bucket)
+    {
+        summary.count += histograms[probe][bucket];
+    }
+    if (summary.count == 0)
+        return summary;
+    summary.p50 = std::min(percentile(histograms[probe], summary.count, 0.50), double(maxima[probe]));
+    summary.p99 = std::min(percentile(histograms[probe], summary.count, 0.99), double(maxima[probe]));
+    summary.max = double(maxima[probe]);
+    return summary;
+}
+
+const char *Latency::name(Probe probe)
+{
+    static const char *const names[ProbeCount] = { "click", "flood", "win", "render", "save", "load" };
+    return names[probe];
+}
+
+bool Latency::dump(const std::string &path)
+{
+    // One summary row per probe, then the raw non-empty buckets so other percentiles can be worked out later.
+    std::FILE *file = std::fopen(path.c_str(), "w");
+    if (!file)
+        return false;
+    std::fprintf(file, "probe,count,p50_ns,p99_ns,max_ns\n");
+    for (int probe = 0; probe < ProbeCount; ++probe)
+    {
+        Summary stats = summary(static_cast< Probe >(probe));
+        std::fprintf(file, "%s,%llu,%.0f,%.0f,%.0f\n", name(static_cast< Probe >(probe)), static_cast< unsigned long long >(stats.count), stats.p50, stats.p99, stats.max);
+    }
+    std::fprintf(file, "\nprobe,bucket_ns,count\n");
+    for (int probe = 0; probe < ProbeCount; ++probe)
+    {
+        for (int bucket = 0; bucket < BucketCount; ++bucket)
+        {
+            if (histograms[probe][bucket])
+                std::fprintf(file, "%s,%.0f,%llu\n", name(static_cast< Probe >(probe)), bucketMiddle(bucket), static_cast< unsigned long long >(histograms[probe][bucket]));
+        }
+    }
+    return std::fclose(file) == 0;
+}
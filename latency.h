@@ -0,0 +1,69 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Wall-clock latency of the interactive hot paths, kept as log-linear histograms (eight buckets per power of
+// two, so any percentile is within 12.5%). Off unless enabled: a disabled probe is one branch on a flag.
+// Recording is meant for the GUI thread only.
+class Latency
+{
+public:
+    enum Probe
+    {
+        CellClick,
+        FloodFill,
+        WinCheck,
+        Render,
+        Save,
+        Load,
+        ProbeCount
+    };
+    struct Summary
+    {
+        std::uint64_t count = 0;
+        double p50 = 0;
+        double p99 = 0;
+        double max = 0;
+    };
+
+    // Times the enclosing block with the monotonic clock.
+    class Scope
+    {
+    public:
+        explicit Scope(Probe probe) : m_probe(probe), m_running(isEnabled())
+        {
+            if (m_running)
+                m_start = std::chrono::steady_clock::now();
+        }
+        ~Scope()
+        {
+            if (m_running)
+                record(m_probe, static_cast< std::uint64_t >(std::chrono::duration_cast< std::chrono::nanoseconds >(std::chrono::steady_clock::now() - m_start).count()));
+        }
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        Probe m_probe;
+        bool m_running;
+        std::chrono::steady_clock::time_point m_start;
+    };
+
+    static void setEnabled(bool enabled);
+    static bool isEnabled()
+    {
+        return s_enabled;
+    }
+    static void record(Probe probe, std::uint64_t nanoseconds);
+    static Summary summary(Probe probe);
+    static const char *name(Probe probe);
+    static bool dump(const std::string &path);
+
+private:
+    static bool s_enabled;
+};
+
+#endif	  // LATENCY_H
@@ -1,16 +1,253 @@
+#include "chunkedboardview.h"
+#include "chunkedgame.h"
+#include "latency.h"
 #include "mainwindow.h"
+#include "replay.h"
+#include "simulator.h"
 
 #include <QApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QRandomGenerator>
+#include <QVBoxLayout>
+
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <string>
+
+namespace
+{
+int simulate(int argc, char *argv[])
+{
+    Simulator::Settings settings;
+    bool json = false;
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string option(argv[i]);
+        bool hasValue = i + 1 < argc;
+        if (option == "--width" && hasValue)
+            settings.width = std::atoi(argv[++i]);
+        else if (option == "--height" && hasValue)
+            settings.height = std::atoi(argv[++i]);
+        else if (option == "--mines" && hasValue)
+            settings.mines = std::atoi(argv[++i]);
+        else if (option == "--games" && hasValue)
+            settings.games = std::atoll(argv[++i]);
+        else if (option == "--seed" && hasValue)
+            settings.firstSeed = std::strtoull(argv[++i], nullptr, 10);
+        else if (option == "--threads" && hasValue)
+            settings.threads = std::atoi(argv[++i]);
+        else if (option == "--safe")
+            settings.safeOpening = true;
+        else if (option == "--no-guess")
+            settings.noGuess = true;
+        else if (option == "--json")
+            json = true;
+        else
+            settings.games = -1;
+    }
+    // As in MainWindow::validateInput, the cell count is taken in 64 bits and must fit BoardModel's int indices.
+    if (settings.games < 1 || settings.width < 1 || settings.height < 1 || qint64(settings.width) * settings.height > std::numeric_limits< int >::max() ||
+        settings.mines < 1 || settings.mines >= qint64(settings.width) * settings.height)
+    {
+        std::fprintf(stderr,
+                     "usage: %s sim [--width W] [--height H] [--mines M] [--games N] [--seed S] [--threads T] [--safe] [--no-guess] [--json]\n",
+                     argv[0]);
+        return 2;
+    }
+    Simulator::Report report = Simulator(settings).run();
+    double games = double(report.games);
+    double winRate = report.wins / games;
+    double threeBV = report.threeBV / games;
+    double guesses = report.guesses / games;
+    double speed = report.seconds > 0 ? games / report.seconds : 0;
+    if (json)
+    {
+        std::printf("{\"width\": %d, \"height\": %d, \"mines\": %d, \"games\": %lld, \"wins\": %lld, \"win_rate\": %.6f, "
+                    "\"mean_3bv\": %.3f, \"guesses_per_game\": %.4f, \"games_per_second\": %.1f}\n",
+                    settings.width, settings.height, settings.mines, report.games, report.wins, winRate, threeBV, guesses, speed);
+    }
+    else
+    {
+        std::printf("width,height,mines,games,wins,win_rate,mean_3bv,guesses_per_game,games_per_second\n");
+        std::printf("%d,%d,%d,%lld,%lld,%.6f,%.3f,%.4f,%.1f\n",
+                    settings.width, settings.height, settings.mines, report.games, report.wins, winRate, threeBV, guesses, speed);
+    }
+    return 0;
+}
+
+int replay(int argc, char *argv[])
+{
+    // Plays a recording through GameLogic without a window, as fast as it will go, to time the engine
+    // on real games and to check that a replay ends on the same board every run.
+    QString path;
+    int repeat = 1;
+    bool json = false;
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string option(argv[i]);
+        if (option == "--repeat" && i + 1 < argc)
+            repeat = std::atoi(argv[++i]);
+        else if (option == "--json")
+            json = true;
+        else if (path.isEmpty())
+            path = QString::fromLocal8Bit(argv[i]);
+        else
+            repeat = 0;
+    }
+    QFile file(path);
+    Replay::Header header;
+    std::vector< Replay::Move > moves;
+    if (path.isEmpty() || repeat < 1 || !file.open(QIODevice::ReadOnly))
+    {
+        std::fprintf(stderr, "usage: %s replay FILE [--repeat N] [--json]\n", argv[0]);
+        return 2;
+    }
+    QByteArray data = file.readAll();
+    if (!Replay::decode(reinterpret_cast< const std::uint8_t * >(data.constData()), std::size_t(data.size()), header, moves))
+    {
+        std::fprintf(stderr, "%s: not a replay file\n", qPrintable(path));
+        return 1;
+    }
+    QCoreApplication app(argc, argv);
+    BoardModel board;
+    bool changeDbg = false, leftHanded = false, safeOpening = false, noGuess = false, firstMove = true, rus = false;
+    quint64 seed = header.seed;
+    GameLogic logic(changeDbg, leftHanded, safeOpening, noGuess, firstMove, rus, seed, board);
+    const char *result = "unfinished";
+    QObject::connect(&logic, &GameLogic::boardRevealed, [&result](int exploded) { result = exploded < 0 ? "won" : "lost"; });
+    QElapsedTimer timer;
+    timer.start();
+    for (int run = 0; run < repeat; ++run)
+    {
+        board.unpack(header.width, header.height, header.cells.data(), header.cells.size());
+        logic.startGame(-1);
+        firstMove = header.firstMove;
+        safeOpening = header.safeOpening;
+        result = "unfinished";
+        for (const Replay::Move &move : moves)
+        {
+            logic.playMove(move.index, Qt::MouseButton(move.button));
+        }
+    }
+    double seconds = timer.nsecsElapsed() / 1e9;
+    // FNV-1a over the packed final board: equal checksums mean the replay ended in the same position.
+    std::uint64_t checksum = 14695981039346656037ull;
+    for (std::uint8_t byte : board.pack())
+    {
+        checksum = (checksum ^ byte) * 1099511628211ull;
+    }
+    double speed = seconds > 0 ? double(moves.size()) * repeat / seconds : 0;
+    if (json)
+    {
+        std::printf("{\"moves\": %zu, \"result\": \"%s\", \"checksum\": \"%016llx\", \"seconds\": %.6f, \"moves_per_second\": %.1f}\n",
+                    moves.size(), result, static_cast< unsigned long long >(checksum), seconds, speed);
+    }
+    else
+    {
+        std::printf("moves,result,checksum,seconds,moves_per_second\n");
+        std::printf("%zu,%s,%016llx,%.6f,%.1f\n", moves.size(), result, static_cast< unsigned long long >(checksum), seconds, speed);
+    }
+    return 0;
+}
+
+int explore(int argc, char *argv[])
+{
+    // A board far larger than memory, built chunk by chunk as play and scrolling reach it. It runs in its own
+    // window, next to rather than inside MainWindow, because it has no save, journal, hint or heat map.
+    qint64 width = 1000000;
+    qint64 height = 1000000;
+    qint64 mines = -1;
+    quint64 seed = 0;
+    bool seeded = false;
+    bool valid = true;
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string option(argv[i]);
+        bool hasValue = i + 1 < argc;
+        if (option == "--width" && hasValue)
+            width = std::atoll(argv[++i]);
+        else if (option == "--height" && hasValue)
+            height = std::atoll(argv[++i]);
+        else if (option == "--mines" && hasValue)
+            mines = std::atoll(argv[++i]);
+        else if (option == "--seed" && hasValue)
+        {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+            seeded = true;
+        }
+        else if (option == "-platform" && hasValue)
+            ++i;
+        else
+            valid = false;
+    }
+    const qint64 maximum = std::numeric_limits< int >::max();
+    if (width >= 1 && width <= maximum && height >= 1 && height <= maximum && mines < 0)
+        mines = width * height / 100 * 15;
+    if (!valid || width < 1 || width > maximum || height < 1 || height > maximum || mines < 1 || mines > width * height - 9)
+    {
+        std::fprintf(stderr, "usage: %s huge [--width W] [--height H] [--mines M] [--seed S]\n", argv[0]);
+        return 2;
+    }
+    QApplication app(argc, argv);
+    if (!seeded)
+        seed = QRandomGenerator::global()->generate64();
+    ChunkedBoard board;
+    board.reset(width, height, mines, seed);
+    QWidget window;
+    QVBoxLayout *layout = new QVBoxLayout(&window);
+    QLabel *counter = new QLabel(QString("Mines left: %1").arg(board.remainingMines()));
+    counter->setAlignment(Qt::AlignCenter);
+    ChunkedBoardView *view = new ChunkedBoardView(board);
+    ChunkedGame game(board, false);
+    layout->addWidget(counter);
+    layout->addWidget(view);
+    QObject::connect(view, &ChunkedBoardView::cellClicked, &game, &ChunkedGame::handleCellClick);
+    QObject::connect(&game, &ChunkedGame::boardChanged, view, &ChunkedBoardView::refreshAll);
+    QObject::connect(&game, &ChunkedGame::boardRevealed, view, &ChunkedBoardView::setRevealed);
+    QObject::connect(&game, &ChunkedGame::remainingMinesChanged, counter, [&board, counter]() { counter->setText(QString("Mines left: %1").arg(board.remainingMines())); });
+    QObject::connect(&game, &ChunkedGame::showMessage, &window, [&window](const QString &title, const QString &message) { QMessageBox::information(&window, title, message); });
+    window.setWindowTitle(QString("Minesweeper %1 x %2").arg(width).arg(height));
+    window.show();
+    view->resetBoard();
+    return app.exec();
+}
+}	 // namespace
 
 int main(int argc, char *argv[])
 {
+    if (argc > 1 && std::string(argv[1]) == "sim")
+    {
+        return simulate(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "replay")
+    {
+        return replay(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "huge")
+    {
+        return explore(argc, argv);
+    }
     QApplication app(argc, argv);
     bool dbg = false;
     if (argc > 1 && std::string(argv[1]) == "dbg")
     {
         dbg = true;
     }
+    // Debug sessions always measure; MINESWEEPER_LATENCY turns it on for ordinary ones.
+    Latency::setEnabled(dbg || qEnvironmentVariableIsSet("MINESWEEPER_LATENCY"));
     MainWindow window(dbg);
     window.show();
-    return app.exec();
+    if (argc > 2 && std::string(argv[1]) == "play" && !window.playReplay(QString::fromLocal8Bit(argv[2])))
+    {
+        std::fprintf(stderr, "%s: not a replay file\n", argv[2]);
+        return 1;
+    }
+    int result = app.exec();
+    if (Latency::isEnabled())
+    {
+        Latency::dump((QCoreApplication::applicationDirPath() + "/latency.csv").toLocal8Bit().toStdString());
+    }
+    return result;
 }
@@ -1,22 +1,38 @@
-#include "cell.h"
 #include "mainwindow.h"
 
+#include "latency.h"
+#include "savegame.h"
+
 #include <QCloseEvent>
 #include <QCoreApplication>
+#include <QDataStream>
+#include <QDateTime>
 #include <QFile>
 #include <QMenuBar>
 #include <QMessageBox>
 #include <QRandomGenerator>
-#include <QSettings>
 #include <QTimer>
 
+#include <limits>
+
+namespace
+{
+const quint32 JournalMagic = 0x4d53574a;
+const quint16 JournalVersion = 1;
+}	 // namespace
+
 MainWindow::MainWindow(bool dbg, QWidget *parent) :
-    QMainWindow(parent), isDbg(dbg), gameAreaWidget(new QWidget(this)), widthInput(new QLineEdit(this)),
-    heightInput(new QLineEdit(this)), minesInput(new QLineEdit(this))
+    QMainWindow(parent), isDbg(dbg), boardPool(QRandomGenerator::global()->generate64()), gameAreaWidget(new QWidget(this)), widthInput(new QLineEdit(this)),
+    heightInput(new QLineEdit(this)), minesInput(new QLineEdit(this)), seedInput(new QLineEdit(this))
 {
-    if (QFile::exists(getIniFilePath()))
+    playbackTimer.setSingleShot(true);
+    connect(&playbackTimer, &QTimer::timeout, this, &MainWindow::playNextMove);
+    connect(&latencyTimer, &QTimer::timeout, this, &MainWindow::updateLatencyOverlay);
+    if (loadGameState())
     {
-        loadGameState();
+        replayJournal();
+        saveGameState();
+        startRecording(true);
     }
     else
     {
@@ -37,21 +53,7 @@ void MainWindow::closeEvent(QCloseEvent *event)
     event->accept();
 }
 
-void MainWindow::resizeEvent(QResizeEvent *event)
-{
-    QSize newSize = event->size();
-    if (gameGridLayout && gameGridLayout->count() != 0)
-    {
-        int minSide = qMin(newSize.width(), newSize.height());
-        if (minSide < 400)
-            resize(400, 400);
-        else
-            resize(minSide, minSide);
-    }
-    QWidget::resizeEvent(event);
-}
-
-bool MainWindow::validateInput(int &width, int &height, int &mines)
+bool MainWindow::validateInput(int &width, int &height, int &mines, quint64 &seed)
 {
     bool valid = true;
     width = widthInput->text().toInt(&valid);
@@ -63,8 +65,18 @@ bool MainWindow::validateInput(int &width, int &height, int &mines)
     mines = minesInput->text().toInt(&valid);
     if (!valid)
         return false;
-    if (mines >= width * height || mines < 1 || height < 1 || width < 1)
+    // The product is taken in 64 bits: two valid ints can overflow an int, and BoardModel indexes cells by int.
+    // Each side is also kept to what BoardView can lay out in int pixels at its largest cells.
+    if (height < 1 || width < 1 || width > BoardView::MaximumSide || height > BoardView::MaximumSide)
+        return false;
+    if (qint64(width) * height > std::numeric_limits< int >::max() || mines >= width * height || mines < 1)
         return false;
+    if (seedInput->text().trimmed().isEmpty())
+    {
+        seed = QRandomGenerator::global()->generate64();
+        return true;
+    }
+    seed = seedInput->text().trimmed().toULongLong(&valid);
     return valid;
 }
 
@@ -84,6 +96,7 @@ void MainWindow::cleaning()
         delete gameGridLayout;
         gameGridLayout = nullptr;
     }
+    setMinimumSize(0, 0);
     menuBar()->clear();
     if (toolBar)
     {
@@ -96,12 +109,17 @@ void MainWindow::cleaning()
         delete gameLogic;
         gameLogic = nullptr;
     }
+    boardView = nullptr;
+    latencyLabel = nullptr;
+    playbackTimer.stop();
+    latencyTimer.stop();
 }
 
 void MainWindow::startNewGame()
 {
     int width, height, mines;
-    if (!validateInput(width, height, mines))
+    quint64 seed;
+    if (!validateInput(width, height, mines, seed))
     {
         QString message = "Invalid input! Please enter valid numeric values!";
         if (isRus)
@@ -111,7 +129,8 @@ void MainWindow::startNewGame()
         QMessageBox::warning(this, "!", message);
         return;
     }
-    createGameArea(width, height, mines);
+    isNoGuess = noGuessBox->isChecked();
+    createGameArea(width, height, mines, seed);
 }
 
 void MainWindow::createMenu()
@@ -122,6 +141,10 @@ void MainWindow::createMenu()
     widthLabel = new QLabel("Width:");
     heightLabel = new QLabel("Height:");
     minesLabel = new QLabel("Mines:");
+    seedLabel = new QLabel("Seed:");
+    seedInput->setPlaceholderText("random");
+    noGuessBox = new QCheckBox("No-guess board");
+    noGuessBox->setChecked(isNoGuess);
     changeEngRus = new QPushButton("Change Language to Russian");
     changeRusEng = new QPushButton("Change Language to English");
     startButton = new QPushButton("Start New Game");
@@ -154,15 +177,20 @@ void MainWindow::createMenu()
     QHBoxLayout *widthLayout = new QHBoxLayout;
     QHBoxLayout *heightLayout = new QHBoxLayout;
     QHBoxLayout *minesLayout = new QHBoxLayout;
+    QHBoxLayout *seedLayout = new QHBoxLayout;
     widthLayout->addWidget(widthLabel);
     widthLayout->addWidget(widthInput);
     heightLayout->addWidget(heightLabel);
     heightLayout->addWidget(heightInput);
     minesLayout->addWidget(minesLabel);
     minesLayout->addWidget(minesInput);
+    seedLayout->addWidget(seedLabel);
+    seedLayout->addWidget(seedInput);
     inputLayout->addLayout(widthLayout);
     inputLayout->addLayout(heightLayout);
     inputLayout->addLayout(minesLayout);
+    inputLayout->addLayout(seedLayout);
+    inputLayout->addWidget(noGuessBox);
     inputLayout->addWidget(startButton);
     inputLayout->addWidget(changeEngRus);
     inputLayout->addWidget(changeRusEng);
@@ -171,43 +199,155 @@ void MainWindow::createMenu()
     setCentralWidget(menuWidget);
 }
 
-void MainWindow::createGameArea(int width, int height, int mines)
+void MainWindow::createGameArea(int width, int height, int mines, quint64 seed)
 {
-    cleaning();
-    gameGridLayout = new QGridLayout(gameAreaWidget);
-    gameGridLayout->setSpacing(0);
-    isFirstMove = true;
-    remainingMines = mines;
+    setUpdatesEnabled(false);
     currentWidth = width;
     currentHeight = height;
     currentMines = mines;
-    gameLogic = new GameLogic(changeDbg, isLeftHandedMode, isFirstMove, isRus, currentWidth, currentHeight, remainingMines, gameGridLayout, this);
+    currentSeed = seed;
+    gameId = QRandomGenerator::global()->generate64();
+    board.reset(width, height);
+    showGameArea();
+    gameLogic->placeMines(mines);
+    if (gameLogic->isGenerating())
+    {
+        // A no-guess board arrives later through boardReady; until then nothing is saved or recorded for it.
+        journalFile.close();
+        replayFile.close();
+        boardView->setEnabled(false);
+        setUpdatesEnabled(true);
+        return;
+    }
+    updateMineCounter();
+    setUpdatesEnabled(true);
+    saveGameState();
+    startRecording(false);
+}
+
+void MainWindow::generatedGameArea()
+{
+    boardView->setEnabled(true);
+    updateMineCounter();
+    saveGameState();
+    startRecording(false);
+}
+
+void MainWindow::createPooledGameArea(BoardPool::Entry &entry)
+{
+    setUpdatesEnabled(false);
+    currentSeed = entry.seed;
+    gameId = QRandomGenerator::global()->generate64();
+    board = std::move(entry.board);
+    showGameArea();
+    gameLogic->startGame(entry.start);
+    updateMineCounter();
+    setUpdatesEnabled(true);
+    saveGameState();
+    startRecording(false);
+}
+
+void MainWindow::showGameArea()
+{
+    // A game already on screen keeps its widgets, actions and connections; only the model under them changes.
+    playbackTimer.stop();
+    if (boardView)
+    {
+        boardView->resetBoard();
+        boardView->setEnabled(true);
+        boardPool.configure(currentWidth, currentHeight, currentMines, isNoGuess);
+        return;
+    }
+    cleaning();
+    setupGameArea();
+}
+
+void MainWindow::setupGameArea()
+{
+    // Any shape will do, since BoardView scrolls and fits the board itself; it just should not get too small.
+    setMinimumSize(400, 400);
+    gameGridLayout = new QGridLayout(gameAreaWidget);
+    gameGridLayout->setSpacing(0);
+    gameLogic = new GameLogic(changeDbg, isLeftHandedMode, isSafeOpening, isNoGuess, isFirstMove, isRus, currentSeed, board, this);
     connect(gameLogic, &GameLogic::showMessage, this, &MainWindow::displayMessage);
-    mineCounterLabel = new QLabel(QString("Mines left: %1").arg(remainingMines));
+    connect(gameLogic, &GameLogic::moveMade, this, &MainWindow::appendMove);
+    connect(gameLogic, &GameLogic::moveMade, this, &MainWindow::recordMove);
+    boardView = new BoardView(board, gameAreaWidget);
+    connect(boardView, &BoardView::cellClicked, gameLogic, &GameLogic::handleCellClick);
+    connect(gameLogic, &GameLogic::cellsChanged, boardView, &BoardView::refreshCells);
+    connect(gameLogic, &GameLogic::cellsHighlighted, boardView, &BoardView::setHighlighted);
+    connect(gameLogic, &GameLogic::peekChanged, boardView, &BoardView::setPeek);
+    connect(gameLogic, &GameLogic::heatMapChanged, boardView, &BoardView::setHeatMap);
+    connect(gameLogic, &GameLogic::remainingMinesChanged, this, &MainWindow::updateMineCounter);
+    connect(gameLogic, &GameLogic::boardReady, this, &MainWindow::generatedGameArea);
+    connect(gameLogic,
+            &GameLogic::boardRevealed,
+            this,
+            [this](int clickedMine)
+            {
+                boardView->setExploded(clickedMine);
+                boardView->refreshAll();
+            });
+    mineCounterLabel = new QLabel(QString("Mines left: %1").arg(currentMines));
     mineCounterLabel->setAlignment(Qt::AlignCenter);
-    gameGridLayout->addWidget(mineCounterLabel, 0, 0, 1, width);
+    gameGridLayout->addWidget(mineCounterLabel, 0, 0);
+    gameGridLayout->addWidget(boardView, 1, 0);
     sameNewGame = new QAction("Start new game with same parameters", this);
     newNewGame = new QAction("Start new game with new parameters", this);
     leftHanded = new QAction("Left-handed mode", this);
+    safeOpening = new QAction("Safe first opening", this);
+    hint = new QAction("Hint", this);
     changeEnRu = new QAction("Change Language to Russian", this);
     changeRuEn = new QAction("Change Language to English", this);
     QMenu *menu = menuBar()->addMenu(">***<");
     menu->addAction(sameNewGame);
     menu->addAction(newNewGame);
     menu->addAction(leftHanded);
+    menu->addAction(safeOpening);
+    menu->addAction(hint);
     menu->addAction(changeEnRu);
     menu->addAction(changeRuEn);
     toolBar = addToolBar("Minesweeper");
     toolBar->addAction(sameNewGame);
     toolBar->addAction(newNewGame);
     toolBar->addAction(leftHanded);
+    toolBar->addAction(safeOpening);
+    toolBar->addAction(hint);
     toolBar->addAction(changeEnRu);
     toolBar->addAction(changeRuEn);
     if (isDbg)
     {
         dbgMode = new QAction("Debug mode", this);
+        heatMap = new QAction("Mine probabilities", this);
+        latencyStats = new QAction("Latency", this);
         menu->addAction(dbgMode);
+        menu->addAction(heatMap);
+        menu->addAction(latencyStats);
         toolBar->addAction(dbgMode);
+        toolBar->addAction(heatMap);
+        toolBar->addAction(latencyStats);
+        connect(heatMap, &QAction::triggered, gameLogic, &GameLogic::toggleHeatMap);
+        // A label over the board rather than something BoardView paints, so it stays out of the render timings.
+        latencyLabel = new QLabel(boardView);
+        latencyLabel->setStyleSheet("background: rgba(255, 255, 255, 200); padding: 4px;");
+        latencyLabel->move(8, 8);
+        latencyLabel->hide();
+        connect(latencyStats,
+                &QAction::triggered,
+                this,
+                [this]()
+                {
+                    latencyLabel->setVisible(!latencyLabel->isVisible());
+                    if (latencyLabel->isVisible())
+                    {
+                        updateLatencyOverlay();
+                        latencyTimer.start(500);
+                    }
+                    else
+                    {
+                        latencyTimer.stop();
+                    }
+                });
         connect(
             dbgMode,
             &QAction::triggered,
@@ -221,6 +361,8 @@ void MainWindow::createGameArea(int width, int height, int mines)
     connect(sameNewGame, &QAction::triggered, this, &MainWindow::restartWithSameParameters);
     connect(newNewGame, &QAction::triggered, this, &MainWindow::restartWithNewParameters);
     connect(leftHanded, &QAction::triggered, this, [this]() { isLeftHandedMode = !isLeftHandedMode; });
+    connect(safeOpening, &QAction::triggered, gameLogic, &GameLogic::toggleSafeOpening);
+    connect(hint, &QAction::triggered, gameLogic, &GameLogic::showHint);
     connect(
         changeEnRu,
         &QAction::triggered,
@@ -245,35 +387,6 @@ void MainWindow::createGameArea(int width, int height, int mines)
                 ruEnGame();
             }
         });
-
-    for (int row = 1; row <= height; ++row)
-    {
-        for (int col = 0; col < width; ++col)
-        {
-            Cell *cell = new Cell(row, col, gameAreaWidget);
-            gameGridLayout->addWidget(cell, row, col);
-            cell->setMinimumSize(50, 50);
-            cell->setText(" ");
-            connect(cell,
-                    &Cell::cellClicked,
-                    this,
-                    [this](Cell *cell, Qt::MouseButton button) { gameLogic->handleCellClick(cell, button); });
-            connect(
-                cell,
-                &Cell::flagChanged,
-                this,
-                [this](int change)
-                {
-                    remainingMines += change;
-                    if (isRus)
-                        mineCounterLabel->setText(QString("Осталось мин: %1").arg(remainingMines));
-                    else
-                        mineCounterLabel->setText(QString("Mines left: %1").arg(remainingMines));
-                });
-        }
-    }
-    gameLogic->placeMines(width, height, mines);
-    gameLogic->calculateAdjacentMines(width, height);
     gameAreaWidget->setLayout(gameGridLayout);
     setCentralWidget(gameAreaWidget);
     if (isRus)
@@ -284,104 +397,277 @@ void MainWindow::createGameArea(int width, int height, int mines)
     {
         ruEnGame();
     }
+    boardPool.configure(currentWidth, currentHeight, currentMines, isNoGuess);
 }
 
 void MainWindow::saveGameState()
 {
-    if (!gameGridLayout || gameGridLayout->count() == 0)
+    Latency::Scope timing(Latency::Save);
+    if (!gameGridLayout || gameGridLayout->count() == 0 || gameLogic->isGenerating())
     {
         return;
     }
-    QSettings settings(getIniFilePath(), QSettings::IniFormat);
-    settings.beginGroup("Game");
-    settings.setValue("width", currentWidth);
-    settings.setValue("height", currentHeight);
-    settings.setValue("mines", currentMines);
-    settings.setValue("remainingMines", remainingMines);
-    settings.setValue("isLeftHandedMode", isLeftHandedMode);
-    settings.setValue("isRus", isRus);
-    settings.setValue("isFirstMove", isFirstMove);
-    settings.endGroup();
-    settings.beginGroup("Cells");
-    for (int row = 1; row <= currentHeight; ++row)
-    {
-        for (int col = 0; col < currentWidth; ++col)
+    journalId = QRandomGenerator::global()->generate64();
+    SaveGame::Snapshot snapshot;
+    snapshot.journalId = journalId;
+    snapshot.gameId = gameId;
+    snapshot.width = currentWidth;
+    snapshot.height = currentHeight;
+    snapshot.mines = currentMines;
+    snapshot.seed = currentSeed;
+    snapshot.leftHanded = isLeftHandedMode;
+    snapshot.safeOpening = isSafeOpening;
+    snapshot.noGuess = isNoGuess;
+    snapshot.rus = isRus;
+    snapshot.firstMove = isFirstMove;
+    snapshot.cells = board.pack();
+    if (SaveGame::write(getSaveFilePath(), snapshot))
+    {
+        startJournal();
+    }
+}
+
+bool MainWindow::loadGameState()
+{
+    Latency::Scope timing(Latency::Load);
+    SaveGame::Snapshot snapshot;
+    if (!SaveGame::read(getSaveFilePath(), snapshot))
+    {
+        return false;
+    }
+    cleaning();
+    if (!board.unpack(snapshot.width, snapshot.height, snapshot.cells.data(), snapshot.cells.size()))
+    {
+        return false;
+    }
+    currentWidth = snapshot.width;
+    currentHeight = snapshot.height;
+    currentMines = snapshot.mines;
+    currentSeed = snapshot.seed;
+    journalId = snapshot.journalId;
+    gameId = snapshot.gameId;
+    isLeftHandedMode = snapshot.leftHanded;
+    isSafeOpening = snapshot.safeOpening;
+    isNoGuess = snapshot.noGuess;
+    isRus = snapshot.rus;
+    isFirstMove = snapshot.firstMove;
+    setupGameArea();
+    return true;
+}
+
+void MainWindow::startJournal()
+{
+    journalFile.close();
+    journalFile.setFileName(getJournalFilePath());
+    journalMoves = 0;
+    if (!journalFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        return;
+    }
+    QDataStream out(&journalFile);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << JournalMagic << JournalVersion << journalId;
+    journalFile.flush();
+}
+
+void MainWindow::appendMove(int index, Qt::MouseButton button)
+{
+    if (journalMoves >= qMax(1024, board.cellCount() / 64))
+    {
+        saveGameState();
+    }
+    if (!journalFile.isOpen())
+    {
+        return;
+    }
+    QDataStream out(&journalFile);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << quint32(index) << quint8(button) << QDateTime::currentMSecsSinceEpoch();
+    journalFile.flush();
+    ++journalMoves;
+}
+
+void MainWindow::replayJournal()
+{
+    QFile file(getJournalFilePath());
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return;
+    }
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_0);
+    quint32 magic;
+    quint16 version;
+    quint64 id;
+    in >> magic >> version >> id;
+    if (in.status() != QDataStream::Ok || magic != JournalMagic || version != JournalVersion || id != journalId)
+    {
+        return;
+    }
+    gameLogic->blockSignals(true);
+    gameLogic->beginTransaction();
+    for (;;)
+    {
+        quint32 index;
+        quint8 button;
+        qint64 timestamp;
+        in >> index >> button >> timestamp;
+        if (in.status() != QDataStream::Ok || index >= quint32(board.cellCount()))
         {
-            Cell *cell = qobject_cast< Cell * >(gameGridLayout->itemAtPosition(row, col)->widget());
-            if (cell)
-            {
-                QString key = QString("cell_%1_%2").arg(row).arg(col);
-                settings.setValue(key + "_isMine", cell->isMine());
-                settings.setValue(key + "_state", cell->currentState());
-                settings.setValue(key + "_adjacentMines", cell->adjacentMines());
-            }
+            break;
         }
+        gameLogic->playMove(int(index), Qt::MouseButton(button));
     }
-    settings.endGroup();
+    // The moves stay silent, but their combined result is reported once so a lost game comes back with its
+    // exploded mine; the end-of-game message was already shown before the restart.
+    gameLogic->blockSignals(false);
+    gameLogic->discardMessage();
+    gameLogic->endTransaction();
+    updateMineCounter();
 }
 
-void MainWindow::loadGameState()
+void MainWindow::startRecording(bool resume)
 {
-    QSettings settings(getIniFilePath(), QSettings::IniFormat);
-    settings.beginGroup("Game");
-    int width = settings.value("width", 10).toInt();
-    int height = settings.value("height", 10).toInt();
-    int mines = settings.value("mines", 10).toInt();
-    createGameArea(width, height, mines);
-    remainingMines = settings.value("remainingMines", mines).toInt();
-    isLeftHandedMode = settings.value("isLeftHandedMode", false).toBool();
-    isRus = settings.value("isRus").toBool();
-    isFirstMove = settings.value("isFirstMove").toBool();
-    settings.endGroup();
-    settings.beginGroup("Cells");
-    for (int row = 1; row <= height; ++row)
+    replayFile.close();
+    replayFile.setFileName(getReplayFilePath());
+    replayClock.start();
+    if (resume && replayFile.open(QIODevice::ReadOnly))
     {
-        for (int col = 0; col < width; ++col)
+        // Only a recording of this very game may be continued; anything else, such as the recording left behind
+        // by a played-back file, is replaced by a fresh one starting from the restored position.
+        QByteArray data = replayFile.readAll();
+        replayFile.close();
+        Replay::Header recorded;
+        std::vector< Replay::Move > moves;
+        if (Replay::decode(reinterpret_cast< const std::uint8_t * >(data.constData()), std::size_t(data.size()), recorded, moves) &&
+            recorded.gameId == gameId)
         {
-            Cell *cell = qobject_cast< Cell * >(gameGridLayout->itemAtPosition(row, col)->widget());
-            if (cell)
+            // A move cut short by a crash is dropped, so the next one does not run into its bytes.
+            std::vector< std::uint8_t > complete = Replay::encode(recorded);
+            for (const Replay::Move &move : moves)
             {
-                QString key = QString("cell_%1_%2").arg(row).arg(col);
-                bool isMine = settings.value(key + "_isMine", false).toBool();
-                int state = settings.value(key + "_state", Cell::Hidden).toInt();
-                int adjacentMines = settings.value(key + "_adjacentMines", 0).toInt();
-                cell->setMine(isMine);
-                cell->setAdjacentMines(adjacentMines);
-                if (state == Cell::Opened)
-                {
-                    cell->open();
-                }
-                else if (state == Cell::Flagged)
-                {
-                    cell->toggleFlagQuestion();
-                }
-                else if (state == Cell::Question)
-                {
-                    cell->toggleFlagQuestion();
-                    cell->toggleFlagQuestion();
-                }
+                Replay::encode(move, complete);
             }
+            replayFile.resize(qint64(complete.size()));
+            replayFile.open(QIODevice::Append);
+            return;
         }
     }
-    if (isRus)
+    if (!replayFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
     {
-        enRuGame();
+        return;
+    }
+    Replay::Header header;
+    header.width = currentWidth;
+    header.height = currentHeight;
+    header.mines = currentMines;
+    header.seed = currentSeed;
+    header.gameId = gameId;
+    header.safeOpening = isSafeOpening;
+    header.firstMove = isFirstMove;
+    header.cells = board.pack();
+    std::vector< std::uint8_t > bytes = Replay::encode(header);
+    replayFile.write(reinterpret_cast< const char * >(bytes.data()), qint64(bytes.size()));
+    replayFile.flush();
+}
+
+void MainWindow::recordMove(int index, Qt::MouseButton button)
+{
+    if (!replayFile.isOpen())
+    {
+        return;
+    }
+    std::vector< std::uint8_t > bytes;
+    Replay::encode(Replay::Move { index, int(button), quint32(replayClock.restart()) }, bytes);
+    replayFile.write(reinterpret_cast< const char * >(bytes.data()), qint64(bytes.size()));
+    replayFile.flush();
+}
+
+bool MainWindow::playReplay(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+    QByteArray data = file.readAll();
+    Replay::Header header;
+    std::vector< Replay::Move > moves;
+    if (!Replay::decode(reinterpret_cast< const std::uint8_t * >(data.constData()), std::size_t(data.size()), header, moves))
+    {
+        return false;
+    }
+    setUpdatesEnabled(false);
+    if (!board.unpack(header.width, header.height, header.cells.data(), header.cells.size()))
+    {
+        setUpdatesEnabled(true);
+        return false;
+    }
+    // Played moves are not the player's own, so recording stops until the next new game.
+    replayFile.close();
+    currentWidth = header.width;
+    currentHeight = header.height;
+    currentMines = header.mines;
+    currentSeed = header.seed;
+    gameId = QRandomGenerator::global()->generate64();
+    showGameArea();
+    gameLogic->startGame(-1);
+    isFirstMove = header.firstMove;
+    isSafeOpening = header.safeOpening;
+    updateMineCounter();
+    setUpdatesEnabled(true);
+    saveGameState();
+    playbackMoves = std::move(moves);
+    playbackPosition = 0;
+    boardView->setEnabled(false);
+    if (!playbackMoves.empty())
+    {
+        playbackTimer.start(int(playbackMoves.front().delay));
+    }
+    return true;
+}
+
+void MainWindow::playNextMove()
+{
+    const Replay::Move &move = playbackMoves[playbackPosition++];
+    gameLogic->playMove(move.index, Qt::MouseButton(move.button));
+    if (playbackPosition < playbackMoves.size())
+    {
+        playbackTimer.start(int(playbackMoves[playbackPosition].delay));
     }
     else
     {
-        ruEnGame();
+        boardView->setEnabled(true);
+    }
+}
+
+void MainWindow::updateLatencyOverlay()
+{
+    QStringList lines;
+    for (int probe = 0; probe < Latency::ProbeCount; ++probe)
+    {
+        Latency::Summary stats = Latency::summary(Latency::Probe(probe));
+        lines << QString("%1: p50 %2 ms, p99 %3 ms (%4)")
+                     .arg(Latency::name(Latency::Probe(probe)))
+                     .arg(stats.p50 / 1e6, 0, 'f', 3)
+                     .arg(stats.p99 / 1e6, 0, 'f', 3)
+                     .arg(stats.count);
     }
-    settings.endGroup();
+    latencyLabel->setText(lines.join('\n'));
+    latencyLabel->adjustSize();
+    latencyLabel->raise();
 }
 
 void MainWindow::restartWithNewParameters()
 {
     cleaning();
     isLeftHandedMode = false;
+    isSafeOpening = false;
     gameAreaWidget = new QWidget(this);
     widthInput = new QLineEdit(this);
     heightInput = new QLineEdit(this);
     minesInput = new QLineEdit(this);
+    seedInput = new QLineEdit(this);
     createMenu();
     if (isRus)
     {
@@ -395,7 +681,13 @@ void MainWindow::restartWithNewParameters()
 
 void MainWindow::restartWithSameParameters()
 {
-    createGameArea(currentWidth, currentHeight, currentMines);
+    BoardPool::Entry entry;
+    if (boardPool.take(entry))
+    {
+        createPooledGameArea(entry);
+        return;
+    }
+    createGameArea(currentWidth, currentHeight, currentMines, QRandomGenerator::global()->generate64());
 }
 
 void MainWindow::enRuMenu()
@@ -403,6 +695,9 @@ void MainWindow::enRuMenu()
     widthLabel->setText("Ширина:");
     heightLabel->setText("Высота:");
     minesLabel->setText("Мины:");
+    seedLabel->setText("Зерно:");
+    seedInput->setPlaceholderText("случайно");
+    noGuessBox->setText("Поле без угадывания");
     startButton->setText("Начать новую игру");
     changeEngRus->setText("Поменять язык на русский");
     changeRusEng->setText("Поменять язык на английский");
@@ -413,6 +708,9 @@ void MainWindow::ruEnMenu()
     widthLabel->setText("Width:");
     heightLabel->setText("Height:");
     minesLabel->setText("Mines:");
+    seedLabel->setText("Seed:");
+    seedInput->setPlaceholderText("random");
+    noGuessBox->setText("No-guess board");
     startButton->setText("Start New Game");
     changeEngRus->setText("Change Language to Russian");
     changeRusEng->setText("Change Language to English");
@@ -423,11 +721,17 @@ void MainWindow::ruEnGame()
     sameNewGame->setText("Start new game with same parameters");
     newNewGame->setText("Start new game with new parameters");
     leftHanded->setText("Left-handed mode");
+    safeOpening->setText("Safe first opening");
+    hint->setText("Hint");
     changeEnRu->setText("Change Language to Russian");
     changeRuEn->setText("Change Language to English");
     if (isDbg)
+    {
         dbgMode->setText("Debug mode");
-    mineCounterLabel->setText(QString("Mines left: %1").arg(remainingMines));
+        heatMap->setText("Mine probabilities");
+        latencyStats->setText("Latency");
+    }
+    mineCounterLabel->setText(QString("Mines left: %1").arg(board.remainingMines()));
 }
 
 void MainWindow::enRuGame()
@@ -435,14 +739,38 @@ void MainWindow::enRuGame()
     sameNewGame->setText("Начать новую игру с теми же параметрами");
     newNewGame->setText("Начать новую игру с новыми параметрами");
     leftHanded->setText("Левша");
+    safeOpening->setText("Безопасное начало");
+    hint->setText("Подсказка");
     changeEnRu->setText("Поменять язык на русский");
     changeRuEn->setText("Поменять язык на английский");
     if (isDbg)
+    {
         dbgMode->setText("Подглядывалка");
-    mineCounterLabel->setText(QString("Осталось мин: %1").arg(remainingMines));
+        heatMap->setText("Вероятности мин");
+        latencyStats->setText("Задержки");
+    }
+    mineCounterLabel->setText(QString("Осталось мин: %1").arg(board.remainingMines()));
+}
+
+void MainWindow::updateMineCounter()
+{
+    if (isRus)
+        mineCounterLabel->setText(QString("Осталось мин: %1").arg(board.remainingMines()));
+    else
+        mineCounterLabel->setText(QString("Mines left: %1").arg(board.remainingMines()));
+}
+
+QString MainWindow::getSaveFilePath() const
+{
+    return QCoreApplication::applicationDirPath() + "/gamestate.bin";
+}
+
+QString MainWindow::getJournalFilePath() const
+{
+    return QCoreApplication::applicationDirPath() + "/gamestate.journal";
 }
 
-QString MainWindow::getIniFilePath() const
+QString MainWindow::getReplayFilePath() const
 {
-    return QCoreApplication::applicationDirPath() + "/gamestate.ini";
+    return QCoreApplication::applicationDirPath() + "/gamestate.replay";
 }
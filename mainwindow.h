@@ -1,13 +1,20 @@
 #ifndef MAINWINDOW_H
 #define MAINWINDOW_H
 
+#include "boardpool.h"
+#include "boardview.h"
 #include "gamelogic.h"
+#include "replay.h"
 
+#include <QCheckBox>
+#include <QElapsedTimer>
+#include <QFile>
 #include <QGridLayout>
 #include <QLabel>
 #include <QLineEdit>
 #include <QMainWindow>
 #include <QMessageBox>
+#include <QTimer>
 #include <QToolBar>
 
 class MainWindow : public QMainWindow
@@ -17,49 +24,75 @@ class MainWindow : public QMainWindow
 public:
     MainWindow(bool dbg, QWidget *parent = nullptr);
     ~MainWindow();
+
+    bool playReplay(const QString &path);
 public slots:
     void displayMessage(const QString &message1, const QString &message2);
 
 protected:
     void closeEvent(QCloseEvent *event) override;
-    void resizeEvent(QResizeEvent *event) override;
 
 private:
     bool isFirstMove = true;
     bool isLeftHandedMode = false;
+    bool isSafeOpening = false;
+    bool isNoGuess = false;
     bool isDbg = false;
     bool isRus = false;
     bool changeDbg = false;
-    bool validateInput(int &width, int &height, int &mines);
+    bool validateInput(int &width, int &height, int &mines, quint64 &seed);
 
-    int remainingMines = 0;
     int currentWidth = 0;
     int currentHeight = 0;
     int currentMines = 0;
 
+    quint64 currentSeed = 0;
+    quint64 journalId = 0;
+    quint64 gameId = 0;
+
+    int journalMoves = 0;
+
     void cleaning();
     void startNewGame();
     void createMenu();
-    void createGameArea(int width, int height, int mines);
+    void createGameArea(int width, int height, int mines, quint64 seed);
+    void createPooledGameArea(BoardPool::Entry &entry);
+    void generatedGameArea();
+    void showGameArea();
+    void setupGameArea();
     void saveGameState();
-    void loadGameState();
+    bool loadGameState();
+    void startJournal();
+    void appendMove(int index, Qt::MouseButton button);
+    void replayJournal();
+    void startRecording(bool resume);
+    void recordMove(int index, Qt::MouseButton button);
+    void playNextMove();
+    void updateLatencyOverlay();
     void restartWithSameParameters();
     void restartWithNewParameters();
     void enRuMenu();
     void ruEnMenu();
     void enRuGame();
     void ruEnGame();
+    void updateMineCounter();
 
+    BoardModel board;
+    BoardPool boardPool;
     QWidget *gameAreaWidget;
     GameLogic *gameLogic = nullptr;
     QLabel *mineCounterLabel = nullptr;
     QLabel *widthLabel = nullptr;
     QLabel *heightLabel = nullptr;
     QLabel *minesLabel = nullptr;
+    QLabel *seedLabel = nullptr;
     QLineEdit *widthInput = nullptr;
     QLineEdit *heightInput = nullptr;
     QLineEdit *minesInput = nullptr;
+    QLineEdit *seedInput = nullptr;
+    QCheckBox *noGuessBox = nullptr;
     QGridLayout *gameGridLayout = nullptr;
+    BoardView *boardView = nullptr;
     QToolBar *toolBar = nullptr;
     QPushButton *startButton = nullptr;
     QPushButton *changeEngRus = nullptr;
@@ -67,10 +100,24 @@ private:
     QAction *sameNewGame = nullptr;
     QAction *newNewGame = nullptr;
     QAction *leftHanded = nullptr;
+    QAction *safeOpening = nullptr;
+    QAction *hint = nullptr;
     QAction *dbgMode = nullptr;
+    QAction *heatMap = nullptr;
+    QAction *latencyStats = nullptr;
+    QLabel *latencyLabel = nullptr;
     QAction *changeEnRu = nullptr;
     QAction *changeRuEn = nullptr;
-    QString getIniFilePath() const;
+    QFile journalFile;
+    QFile replayFile;
+    QElapsedTimer replayClock;
+    QTimer playbackTimer;
+    QTimer latencyTimer;
+    std::vector< Replay::Move > playbackMoves;
+    std::size_t playbackPosition = 0;
+    QString getSaveFilePath() const;
+    QString getJournalFilePath() const;
+    QString getReplayFilePath() const;
 };
 
 #endif	  // MAINWINDOW_H
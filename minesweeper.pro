@@ -9,15 +9,45 @@ CONFIG += c++17
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
-    cell.cpp \
+    boardmodel.cpp \
+    boardpool.cpp \
+    boardview.cpp \
+    celltiles.cpp \
+    chunkedboard.cpp \
+    chunkedboardview.cpp \
+    chunkedgame.cpp \
     gamelogic.cpp \
+    gamerules.cpp \
+    latency.cpp \
     main.cpp \
-    mainwindow.cpp
+    mainwindow.cpp \
+    noguessgenerator.cpp \
+    probabilityengine.cpp \
+    replay.cpp \
+    savegame.cpp \
+    seededrandom.cpp \
+    simulator.cpp \
+    solver.cpp
 
 HEADERS += \
-    cell.h \
+    boardmodel.h \
+    boardpool.h \
+    boardview.h \
+    celltiles.h \
+    chunkedboard.h \
+    chunkedboardview.h \
+    chunkedgame.h \
     gamelogic.h \
-    mainwindow.h
+    gamerules.h \
+    latency.h \
+    mainwindow.h \
+    noguessgenerator.h \
+    probabilityengine.h \
+    replay.h \
+    savegame.h \
+    seededrandom.h \
+    simulator.h \
+    solver.h
 
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
@@ -0,0 +1,180 @@
+#include "noguessgenerator.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace
+{
+const int MinimumRepairs = 32;
+}	 // namespace
+
+NoGuessGenerator::NoGuessGenerator(int width, int height, int mines) :
+    m_width(width), m_height(height), m_mines(mines), m_threadCount(0), m_maximumAttempts(4096), m_timeBudget(5000), m_cancelled(false)
+{
+}
+
+void NoGuessGenerator::setThreadCount(int threads)
+{
+    m_threadCount = threads;
+}
+
+void NoGuessGenerator::setMaximumAttempts(int attempts)
+{
+    m_maximumAttempts = attempts;
+}
+
+void NoGuessGenerator::setTimeBudget(int milliseconds)
+{
+    m_timeBudget = milliseconds;
+}
+
+void NoGuessGenerator::cancel()
+{
+    m_cancelled = true;
+}
+
+bool NoGuessGenerator::generate(std::uint64_t seed, BoardModel &board, int &start)
+{
+    if (m_width < 1 || m_height < 1 || m_mines < 1 || m_mines >= m_width * m_height)
+        return false;
+    // Attempts are numbered and each draws from its own seed, and the lowest successful number wins, so a search
+    // that finishes within its time budget depends only on the seed, never on the thread count or on scheduling.
+    // When the budget runs out first, the attempts that got to run decide the result; callers needing
+    // reproducible boards set the time budget to 0 and rely on the attempt limit alone.
+    Search search;
+    search.seed = seed;
+    search.next = 0;
+    search.best = m_maximumAttempts;
+    search.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(m_timeBudget);
+    search.board = &board;
+    search.start = &start;
+    int threadCount = m_threadCount > 0 ? m_threadCount : static_cast< int >(std::max(1u, std::thread::hardware_concurrency()));
+    std::vector< std::thread > pool;
+    for (int t = 1; t < threadCount; ++t)
+        pool.emplace_back(&NoGuessGenerator::work, this, std::ref(search));
+    work(search);
+    for (std::thread &thread : pool)
+        thread.join();
+    if (search.best >= m_maximumAttempts)
+        return false;
+    for (int i = 0; i < board.cellCount(); ++i)
+    {
+        board.setState(i, BoardModel::Hidden);
+    }
+    return true;
+}
+
+void NoGuessGenerator::work(Search &search) const
+{
+    BoardModel board;
+    Solver solver(board);
+    for (int number = search.next++; !stopped(number, search); number = search.next++)
+    {
+        int start;
+        if (!attempt(number, search, board, solver, start))
+            continue;
+        std::lock_guard< std::mutex > lock(search.mutex);
+        if (number < search.best)
+        {
+            *search.board = board;
+            *search.start = start;
+            search.best = number;
+        }
+    }
+}
+
+bool NoGuessGenerator::attempt(int number, Search &search, BoardModel &board, Solver &solver, int &start) const
+{
+    SeededRandom random(SeededRandom(search.seed + number).next());
+    board.reset(m_width, m_height);
+    board.placeMines(m_mines, random.next());
+    board.calculateAdjacentMines();
+    start = static_cast< int >(random.bounded(board.cellCount()));
+    board.clearSafeZone(start, true, random.next());
+    // Repairs resume play where it got stuck, which is cheap but may rest on numbers that changed since,
+    // so a repaired board is only accepted after a clean replay from the start also clears it.
+    int repairLimit = std::max(MinimumRepairs, board.cellCount() / 16);
+    int repairs = 0;
+    bool clean = true;
+    replay(board, solver, start);
+    for (;;)
+    {
+        if (play(number, search, board, solver))
+        {
+            if (clean)
+                return true;
+            replay(board, solver, start);
+            clean = true;
+            continue;
+        }
+        if (repairs++ == repairLimit || stopped(number, search) || !repair(board, random))
+            return false;
+        clean = false;
+    }
+}
+
+void NoGuessGenerator::replay(BoardModel &board, Solver &solver, int start) const
+{
+    for (int i = 0; i < board.cellCount(); ++i)
+    {
+        board.setState(i, BoardModel::Hidden);
+    }
+    board.openArea(start);
+    solver.reset();
+}
+
+bool NoGuessGenerator::play(int number, const Search &search, BoardModel &board, Solver &solver) const
+{
+    // Play the way a careful player would: open only the cells the solver proves safe.
+    while (!board.isCleared())
+    {
+        if (stopped(number, search))
+            return false;
+        Solver::Result result = solver.solve();
+        if (result.safe.empty())
+            return false;
+        for (int cell : result.safe)
+        {
+            solver.addOpened(board.openArea(cell));
+        }
+    }
+    return true;
+}
+
+bool NoGuessGenerator::repair(BoardModel &board, SeededRandom &random) const
+{
+    // Move one mine off the stuck frontier, preferably into the unexplored interior.
+    std::vector< int > frontier;
+    std::vector< int > interior;
+    std::vector< int > border;
+    int adjacent[8];
+    for (int i = 0; i < board.cellCount(); ++i)
+    {
+        if (board.isOpened(i))
+            continue;
+        bool touching = false;
+        int count = board.neighbours(i, adjacent);
+        for (int k = 0; k < count && !touching; ++k)
+            touching = board.isOpened(adjacent[k]);
+        if (board.isMine(i))
+        {
+            if (touching)
+                frontier.push_back(i);
+        }
+        else
+        {
+            (touching ? border : interior).push_back(i);
+        }
+    }
+    const std::vector< int > &targets = interior.empty() ? border : interior;
+    if (frontier.empty() || targets.empty())
+        return false;
+    board.moveMine(frontier[random.bounded(frontier.size())], targets[random.bounded(targets.size())]);
+    return true;
+}
+
+bool NoGuessGenerator::stopped(int number, const Search &search) const
+{
+    return m_cancelled || number >= search.best || (m_timeBudget > 0 && std::chrono::steady_clock::now() > search.deadline);
+}
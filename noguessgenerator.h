@@ -0,0 +1,54 @@
+#ifndef NOGUESSGENERATOR_H
+#define NOGUESSGENERATOR_H
+
+#include "boardmodel.h"
+#include "seededrandom.h"
+#include "solver.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+class NoGuessGenerator
+{
+public:
+    NoGuessGenerator(int width, int height, int mines);
+
+    void setThreadCount(int threads);
+    void setMaximumAttempts(int attempts);
+    void setTimeBudget(int milliseconds);
+    void cancel();
+
+    bool generate(std::uint64_t seed, BoardModel &board, int &start);
+
+private:
+    struct Search
+    {
+        std::uint64_t seed;
+        std::atomic< int > next;
+        std::atomic< int > best;
+        std::chrono::steady_clock::time_point deadline;
+        std::mutex mutex;
+        BoardModel *board;
+        int *start;
+    };
+
+    void work(Search &search) const;
+    bool attempt(int number, Search &search, BoardModel &board, Solver &solver, int &start) const;
+    void replay(BoardModel &board, Solver &solver, int start) const;
+    bool play(int number, const Search &search, BoardModel &board, Solver &solver) const;
+    bool repair(BoardModel &board, SeededRandom &random) const;
+    bool stopped(int number, const Search &search) const;
+
+    int m_width;
+    int m_height;
+    int m_mines;
+    int m_threadCount;
+    int m_maximumAttempts;
+    int m_timeBudget;
+
+    std::atomic< bool > m_cancelled;
+};
+
+#endif	  // NOGUESSGENERATOR_H
@@ -0,0 +1,377 @@
+#include "probabilityengine.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <thread>
+#include <unordered_map>
+
+namespace
+{
+const double NegativeInfinity = -std::numeric_limits< double >::infinity();
+const int MaximumExactCells = 512;
+
+struct LogDistribution
+{
+    int offset;
+    std::vector< double > values;
+};
+
+double addLog(double a, double b)
+{
+    if (a == NegativeInfinity)
+        return b;
+    if (b == NegativeInfinity)
+        return a;
+    return a > b ? a + std::log1p(std::exp(b - a)) : b + std::log1p(std::exp(a - b));
+}
+
+double logChoose(int n, int k)
+{
+    if (k < 0 || k > n)
+        return NegativeInfinity;
+    return std::lgamma(n + 1.0) - std::lgamma(k + 1.0) - std::lgamma(n - k + 1.0);
+}
+
+LogDistribution convolve(const LogDistribution &a, const LogDistribution &b)
+{
+    LogDistribution result { a.offset + b.offset, std::vector< double >(a.values.size() + b.values.size() - 1, NegativeInfinity) };
+    for (std::size_t i = 0; i < a.values.size(); ++i)
+    {
+        if (a.values[i] == NegativeInfinity)
+            continue;
+        for (std::size_t j = 0; j < b.values.size(); ++j)
+        {
+            result.values[i + j] = addLog(result.values[i + j], a.values[i] + b.values[j]);
+        }
+    }
+    return result;
+}
+}	 // namespace
+
+ProbabilityEngine::ProbabilityEngine(const BoardModel &board) : m_board(board), m_timeBudget(250), m_threadCount(0), m_nodeBudget(0) {}
+
+void ProbabilityEngine::setTimeBudget(int milliseconds)
+{
+    m_timeBudget = milliseconds;
+}
+
+void ProbabilityEngine::setThreadCount(int threads)
+{
+    m_threadCount = threads;
+}
+
+void ProbabilityEngine::setNodeBudget(long long nodes)
+{
+    m_nodeBudget = nodes;
+}
+
+ProbabilityEngine::Result ProbabilityEngine::compute() const
+{
+    Result result;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(m_timeBudget);
+
+    // Visible constraints: every opened number that still borders closed cells.
+    std::unordered_map< int, int > varOf;
+    std::vector< Constraint > constraints;
+    int hidden = 0;
+    int openedMines = 0;
+    int adjacent[8];
+    for (int i = 0; i < m_board.cellCount(); ++i)
+    {
+        if (!m_board.isOpened(i))
+        {
+            ++hidden;
+            continue;
+        }
+        if (m_board.isMine(i))
+        {
+            ++openedMines;
+            continue;
+        }
+        Constraint constraint;
+        constraint.mines = m_board.adjacentMines(i);
+        constraint.count = 0;
+        int count = m_board.neighbours(i, adjacent);
+        for (int k = 0; k < count; ++k)
+        {
+            if (!m_board.isOpened(adjacent[k]))
+                constraint.vars[constraint.count++] = adjacent[k];
+            else if (m_board.isMine(adjacent[k]))
+                --constraint.mines;
+        }
+        if (constraint.count == 0)
+            continue;
+        for (int k = 0; k < constraint.count; ++k)
+        {
+            auto inserted = varOf.emplace(constraint.vars[k], static_cast< int >(result.cells.size()));
+            if (inserted.second)
+                result.cells.push_back(constraint.vars[k]);
+            constraint.vars[k] = inserted.first->second;
+        }
+        constraints.push_back(constraint);
+    }
+    int variables = static_cast< int >(result.cells.size());
+    int interior = hidden - variables;
+    int remaining = m_board.mineCount() - openedMines;
+
+    // Split the frontier into independent components: variables linked through a shared constraint.
+    std::vector< int > parent(variables);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&parent](int v)
+    {
+        while (parent[v] != v)
+            v = parent[v] = parent[parent[v]];
+        return v;
+    };
+    for (const Constraint &constraint : constraints)
+    {
+        for (int k = 1; k < constraint.count; ++k)
+            parent[find(constraint.vars[k])] = find(constraint.vars[0]);
+    }
+    std::vector< int > componentOf(variables, -1);
+    std::vector< int > localOf(variables);
+    std::vector< Component > components;
+    for (int v = 0; v < variables; ++v)
+    {
+        int root = find(v);
+        if (componentOf[root] < 0)
+        {
+            componentOf[root] = static_cast< int >(components.size());
+            components.emplace_back();
+        }
+        componentOf[v] = componentOf[root];
+        Component &component = components[componentOf[v]];
+        localOf[v] = static_cast< int >(component.cells.size());
+        component.cells.push_back(v);
+    }
+    for (Constraint constraint : constraints)
+    {
+        Component &component = components[componentOf[constraint.vars[0]]];
+        for (int k = 0; k < constraint.count; ++k)
+            constraint.vars[k] = localOf[constraint.vars[k]];
+        component.constraints.push_back(constraint);
+    }
+
+    std::atomic< std::size_t > next(0);
+    auto worker = [&]()
+    {
+        for (std::size_t i = next++; i < components.size(); i = next++)
+        {
+            if (components[i].cells.size() > static_cast< std::size_t >(MaximumExactCells))
+                estimate(components[i]);
+            else
+                enumerate(components[i], remaining, deadline);
+        }
+    };
+    std::size_t threadCount = m_threadCount > 0 ? static_cast< std::size_t >(m_threadCount) : std::max(1u, std::thread::hardware_concurrency());
+    threadCount = std::min(threadCount, components.size());
+    std::vector< std::thread > pool;
+    for (std::size_t t = 1; t < threadCount; ++t)
+        pool.emplace_back(worker);
+    worker();
+    for (std::thread &thread : pool)
+        thread.join();
+
+    // Weight each combination of per-component mine counts by the ways to place the rest in the interior.
+    std::vector< LogDistribution > prefix(components.size() + 1, LogDistribution { 0, { 0.0 } });
+    std::vector< LogDistribution > distributions;
+    for (std::size_t i = 0; i < components.size(); ++i)
+    {
+        const Component &component = components[i];
+        result.approximate = result.approximate || component.approximate;
+        int rows = static_cast< int >(component.solutions.size());
+        LogDistribution distribution { component.firstMines, std::vector< double >(rows, NegativeInfinity) };
+        for (int k = 0; k < rows; ++k)
+        {
+            if (component.solutions[k] > 0)
+                distribution.values[k] = std::log(component.solutions[k]);
+        }
+        distributions.push_back(distribution);
+        prefix[i + 1] = convolve(prefix[i], distribution);
+    }
+    const LogDistribution &total = prefix.back();
+    double normaliser = NegativeInfinity;
+    for (std::size_t s = 0; s < total.values.size(); ++s)
+    {
+        int mines = total.offset + static_cast< int >(s);
+        normaliser = addLog(normaliser, total.values[s] + logChoose(interior, remaining - mines));
+    }
+    result.probabilities.assign(variables, 0.0);
+    if (normaliser == NegativeInfinity)
+    {
+        result.approximate = true;
+        return result;
+    }
+    LogDistribution suffix { 0, { 0.0 } };
+    for (std::size_t i = components.size(); i-- > 0;)
+    {
+        const Component &component = components[i];
+        LogDistribution rest = convolve(prefix[i], suffix);
+        std::size_t cellCount = component.cells.size();
+        for (std::size_t k = 0; k < component.solutions.size(); ++k)
+        {
+            if (component.solutions[k] <= 0)
+                continue;
+            double weight = NegativeInfinity;
+            for (std::size_t r = 0; r < rest.values.size(); ++r)
+            {
+                int mines = component.firstMines + static_cast< int >(k) + rest.offset + static_cast< int >(r);
+                weight = addLog(weight, rest.values[r] + logChoose(interior, remaining - mines));
+            }
+            double scale = std::exp(weight - normaliser);
+            for (std::size_t v = 0; v < cellCount; ++v)
+            {
+                result.probabilities[component.cells[v]] += component.cellMines[k * cellCount + v] * scale;
+            }
+        }
+        suffix = convolve(distributions[i], suffix);
+    }
+    if (interior > 0)
+    {
+        double expected = 0;
+        for (std::size_t s = 0; s < total.values.size(); ++s)
+        {
+            int mines = total.offset + static_cast< int >(s);
+            double weight = total.values[s] + logChoose(interior, remaining - mines);
+            if (weight != NegativeInfinity)
+                expected += std::exp(weight - normaliser) * (remaining - mines);
+        }
+        result.interiorProbability = expected / interior;
+    }
+    for (int v = 0; v < variables; ++v)
+    {
+        result.probabilities[v] = std::min(1.0, std::max(0.0, result.probabilities[v]));
+    }
+    return result;
+}
+
+void ProbabilityEngine::enumerate(Component &component, int maxMines, std::chrono::steady_clock::time_point deadline) const
+{
+    int n = static_cast< int >(component.cells.size());
+    int constraintCount = static_cast< int >(component.constraints.size());
+    std::vector< std::vector< int > > varConstraints(n);
+    std::vector< int > assigned(constraintCount, 0);
+    std::vector< int > unassigned(constraintCount);
+    for (int c = 0; c < constraintCount; ++c)
+    {
+        const Constraint &constraint = component.constraints[c];
+        unassigned[c] = constraint.count;
+        for (int k = 0; k < constraint.count; ++k)
+            varConstraints[constraint.vars[k]].push_back(c);
+    }
+
+    // Breadth-first variable order, so constraints become fully assigned (and prune) early.
+    std::vector< int > order;
+    std::vector< char > visited(n, 0);
+    order.push_back(0);
+    visited[0] = 1;
+    for (std::size_t next = 0; next < order.size(); ++next)
+    {
+        for (int c : varConstraints[order[next]])
+        {
+            const Constraint &constraint = component.constraints[c];
+            for (int k = 0; k < constraint.count; ++k)
+            {
+                if (!visited[constraint.vars[k]])
+                {
+                    visited[constraint.vars[k]] = 1;
+                    order.push_back(constraint.vars[k]);
+                }
+            }
+        }
+    }
+
+    component.solutions.assign(n + 1, 0.0);
+    component.cellMines.assign(static_cast< std::size_t >(n + 1) * n, 0.0);
+    std::vector< signed char > choice(n, -1);
+    int mines = 0;
+    long long nodes = 0;
+    auto apply = [&](int var, int value)
+    {
+        bool valid = true;
+        mines += value;
+        for (int c : varConstraints[var])
+        {
+            assigned[c] += value;
+            --unassigned[c];
+            int target = component.constraints[c].mines;
+            valid = valid && assigned[c] <= target && assigned[c] + unassigned[c] >= target;
+        }
+        return valid && mines <= maxMines;
+    };
+    auto undo = [&](int var, int value)
+    {
+        mines -= value;
+        for (int c : varConstraints[var])
+        {
+            assigned[c] -= value;
+            ++unassigned[c];
+        }
+    };
+    int depth = 0;
+    while (depth >= 0)
+    {
+        if (depth == n)
+        {
+            component.solutions[mines] += 1;
+            double *row = component.cellMines.data() + static_cast< std::size_t >(mines) * n;
+            for (int v = 0; v < n; ++v)
+            {
+                if (choice[v] == 1)
+                    row[order[v]] += 1;
+            }
+            --depth;
+            continue;
+        }
+        // The node budget caps work per component the same way on every run; the deadline caps wall time.
+        // A budget of 0 turns that limit off.
+        if ((++nodes & 4095) == 0 &&
+            ((m_nodeBudget > 0 && nodes > m_nodeBudget) || (m_timeBudget > 0 && std::chrono::steady_clock::now() > deadline)))
+        {
+            estimate(component);
+            return;
+        }
+        int var = order[depth];
+        if (choice[depth] >= 0)
+            undo(var, choice[depth]);
+        if (choice[depth] == 1)
+        {
+            choice[depth] = -1;
+            --depth;
+            continue;
+        }
+        ++choice[depth];
+        if (apply(var, choice[depth]))
+            ++depth;
+    }
+}
+
+void ProbabilityEngine::estimate(Component &component) const
+{
+    // Time-bounded fallback: each cell takes the mean density of the numbers around it,
+    // and the component contributes its expected mine count as a single outcome.
+    std::size_t n = component.cells.size();
+    std::vector< double > density(n, 0.0);
+    std::vector< int > weight(n, 0);
+    for (const Constraint &constraint : component.constraints)
+    {
+        for (int k = 0; k < constraint.count; ++k)
+        {
+            density[constraint.vars[k]] += double(constraint.mines) / constraint.count;
+            ++weight[constraint.vars[k]];
+        }
+    }
+    double expected = 0;
+    for (std::size_t v = 0; v < n; ++v)
+    {
+        density[v] /= weight[v];
+        expected += density[v];
+    }
+    component.firstMines = std::min(static_cast< int >(n), static_cast< int >(std::lround(expected)));
+    component.solutions.assign(1, 1.0);
+    component.cellMines = density;
+    component.approximate = true;
+}
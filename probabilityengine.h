@@ -0,0 +1,54 @@
+#ifndef PROBABILITYENGINE_H
+#define PROBABILITYENGINE_H
+
+#include "boardmodel.h"
+
+#include <chrono>
+#include <vector>
+
+class ProbabilityEngine
+{
+public:
+    struct Result
+    {
+        std::vector< int > cells;
+        std::vector< double > probabilities;
+        double interiorProbability = 0;
+        bool approximate = false;
+    };
+    explicit ProbabilityEngine(const BoardModel &board);
+
+    void setTimeBudget(int milliseconds);
+    void setThreadCount(int threads);
+    void setNodeBudget(long long nodes);
+    Result compute() const;
+
+private:
+    struct Constraint
+    {
+        int mines;
+        int count;
+        int vars[8];
+    };
+
+    struct Component
+    {
+        std::vector< int > cells;
+        std::vector< Constraint > constraints;
+        std::vector< double > solutions;
+        std::vector< double > cellMines;
+        int firstMines = 0;
+        bool approximate = false;
+    };
+
+    void enumerate(Component &component, int maxMines, std::chrono::steady_clock::time_point deadline) const;
+    void estimate(Component &component) const;
+
+    const BoardModel &m_board;
+
+    int m_timeBudget;
+    int m_threadCount;
+    long long m_nodeBudget;
+};
+
+#endif	  // PROBABILITYENGINE_H
@@ -0,0 +1,129 @@
+#include "replay.h"
+
+#include "boardmodel.h"
+
+#include <algorithm>
+
+// Layout: "MSRP", a version byte, varint width, height and mines, the seed and the game id as 8 little-endian bytes
+// each (version 1 has no game id), a flags byte and BoardModel::pack() of the starting position. Each move follows as two varints: index * 4 + button code,
+// then milliseconds since the previous move. A typical click costs three or four bytes.
+
+namespace
+{
+const std::uint8_t Magic[4] = { 'M', 'S', 'R', 'P' };
+const std::uint8_t Version = 2;
+
+enum : std::uint8_t
+{
+    SafeOpeningFlag = 0x01,
+    FirstMoveFlag = 0x02
+};
+
+void putFixed(std::uint64_t value, std::vector< std::uint8_t > &out)
+{
+    for (int shift = 0; shift < 64; shift += 8)
+    {
+        out.push_back(static_cast< std::uint8_t >(value >> shift));
+    }
+}
+
+std::uint64_t getFixed(const std::uint8_t *&data)
+{
+    std::uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 8)
+    {
+        value |= std::uint64_t(*data++) << shift;
+    }
+    return value;
+}
+
+void putVarint(std::uint64_t value, std::vector< std::uint8_t > &out)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(static_cast< std::uint8_t >(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast< std::uint8_t >(value));
+}
+
+bool getVarint(const std::uint8_t *&data, const std::uint8_t *end, std::uint64_t &value)
+{
+    value = 0;
+    for (int shift = 0; data < end && shift < 64; shift += 7)
+    {
+        std::uint8_t byte = *data++;
+        value |= std::uint64_t(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+int buttonCode(int button)
+{
+    return button == 2 ? 1 : button == 4 ? 2 : button == 0 ? 3 : 0;
+}
+
+int buttonOf(std::uint64_t code)
+{
+    return code == 3 ? 0 : 1 << code;
+}
+}	 // namespace
+
+std::vector< std::uint8_t > Replay::encode(const Header &header)
+{
+    std::vector< std::uint8_t > out(Magic, Magic + 4);
+    out.push_back(Version);
+    putVarint(header.width, out);
+    putVarint(header.height, out);
+    putVarint(header.mines, out);
+    putFixed(header.seed, out);
+    putFixed(header.gameId, out);
+    out.push_back((header.safeOpening ? SafeOpeningFlag : 0) | (header.firstMove ? FirstMoveFlag : 0));
+    out.insert(out.end(), header.cells.begin(), header.cells.end());
+    return out;
+}
+
+void Replay::encode(const Move &move, std::vector< std::uint8_t > &out)
+{
+    putVarint(std::uint64_t(move.index) * 4 + buttonCode(move.button), out);
+    putVarint(move.delay, out);
+}
+
+bool Replay::decode(const std::uint8_t *data, std::size_t size, Header &header, std::vector< Move > &moves)
+{
+    const std::uint8_t *end = data + size;
+    if (size < 5 || !std::equal(Magic, Magic + 4, data) || data[4] < 1 || data[4] > Version)
+        return false;
+    bool hasGameId = data[4] >= 2;
+    data += 5;
+    std::uint64_t width, height, mines;
+    if (!getVarint(data, end, width) || !getVarint(data, end, height) || !getVarint(data, end, mines))
+        return false;
+    if (width < 1 || height < 1 || width > 0x7fffffff || height > 0x7fffffff || width * height > 0x7fffffff || mines >= width * height || end - data < (hasGameId ? 17 : 9))
+        return false;
+    header.width = int(width);
+    header.height = int(height);
+    header.mines = int(mines);
+    header.seed = getFixed(data);
+    header.gameId = hasGameId ? getFixed(data) : 0;
+    header.safeOpening = *data & SafeOpeningFlag;
+    header.firstMove = *data & FirstMoveFlag;
+    ++data;
+    std::size_t packed = BoardModel::packedSize(header.width, header.height);
+    if (std::size_t(end - data) < packed)
+        return false;
+    header.cells.assign(data, data + packed);
+    data += packed;
+    // A recording cut short mid-move (the game was still running) keeps every complete move before it.
+    moves.clear();
+    std::uint64_t code, delay;
+    while (data < end && getVarint(data, end, code) && getVarint(data, end, delay))
+    {
+        if (code / 4 >= width * height)
+            return false;
+        moves.push_back(Move { int(code / 4), buttonOf(code % 4), std::uint32_t(delay) });
+    }
+    return true;
+}
@@ -0,0 +1,36 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <cstdint>
+#include <vector>
+
+class Replay
+{
+public:
+    struct Header
+    {
+        int width = 0;
+        int height = 0;
+        int mines = 0;
+        std::uint64_t seed = 0;
+        // The game this recording belongs to, as stored in gamestate.bin; 0 in version 1 recordings.
+        std::uint64_t gameId = 0;
+        bool safeOpening = false;
+        bool firstMove = true;
+        std::vector< std::uint8_t > cells;
+    };
+    // button holds the Qt::MouseButton value (left 1, right 2, middle 4) after the left-handed swap,
+    // or 0 (Qt::NoButton) for a safe-opening toggle.
+    struct Move
+    {
+        int index;
+        int button;
+        std::uint32_t delay;
+    };
+
+    static std::vector< std::uint8_t > encode(const Header &header);
+    static void encode(const Move &move, std::vector< std::uint8_t > &out);
+    static bool decode(const std::uint8_t *data, std::size_t size, Header &header, std::vector< Move > &moves);
+};
+
+#endif	  // REPLAY_H
@@ -0,0 +1,74 @@
+#include "savegame.h"
+
+#include "boardmodel.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+
+#include <limits>
+
+namespace
+{
+const quint32 SaveMagic = 0x4d535750;
+const quint16 SaveVersion = 4;
+}	 // namespace
+
+bool SaveGame::write(const QString &path, const Snapshot &snapshot)
+{
+    // QSaveFile only replaces the old save once the new one is complete, so a crash mid-write loses nothing.
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        return false;
+    }
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << SaveMagic << SaveVersion << snapshot.journalId << snapshot.gameId;
+    out << qint32(snapshot.width) << qint32(snapshot.height) << qint32(snapshot.mines) << snapshot.seed;
+    out << snapshot.leftHanded << snapshot.safeOpening << snapshot.noGuess << snapshot.rus << snapshot.firstMove;
+    out.writeRawData(reinterpret_cast< const char * >(snapshot.cells.data()), static_cast< int >(snapshot.cells.size()));
+    return file.commit();
+}
+
+bool SaveGame::read(const QString &path, Snapshot &snapshot)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_0);
+    quint32 magic;
+    quint16 version;
+    in >> magic >> version >> snapshot.journalId >> snapshot.gameId;
+    if (magic != SaveMagic || version != SaveVersion)
+    {
+        return false;
+    }
+    qint32 width, height, mines;
+    in >> width >> height >> mines >> snapshot.seed;
+    in >> snapshot.leftHanded >> snapshot.safeOpening >> snapshot.noGuess >> snapshot.rus >> snapshot.firstMove;
+    // The header is untrusted: the cell count must fit BoardModel's int indices before anything is sized from it,
+    // and the payload must be exactly the packed board, no more and no less.
+    if (in.status() != QDataStream::Ok || width < 1 || height < 1 || qint64(width) * height > std::numeric_limits< int >::max() || mines < 1 ||
+        mines >= qint64(width) * height)
+    {
+        return false;
+    }
+    std::size_t size = BoardModel::packedSize(width, height);
+    if (static_cast< qint64 >(size) != file.bytesAvailable())
+    {
+        return false;
+    }
+    snapshot.cells.resize(size);
+    if (in.readRawData(reinterpret_cast< char * >(snapshot.cells.data()), static_cast< int >(size)) != static_cast< int >(size))
+    {
+        return false;
+    }
+    snapshot.width = width;
+    snapshot.height = height;
+    snapshot.mines = mines;
+    return true;
+}
@@ -0,0 +1,33 @@
+#ifndef SAVEGAME_H
+#define SAVEGAME_H
+
+#include <QString>
+
+#include <cstdint>
+#include <vector>
+
+class SaveGame
+{
+public:
+    // Everything gamestate.bin holds; cells is BoardModel::pack() of the position.
+    struct Snapshot
+    {
+        quint64 journalId = 0;
+        quint64 gameId = 0;
+        int width = 0;
+        int height = 0;
+        int mines = 0;
+        quint64 seed = 0;
+        bool leftHanded = false;
+        bool safeOpening = false;
+        bool noGuess = false;
+        bool rus = false;
+        bool firstMove = true;
+        std::vector< std::uint8_t > cells;
+    };
+
+    static bool write(const QString &path, const Snapshot &snapshot);
+    static bool read(const QString &path, Snapshot &snapshot);
+};
+
+#endif	  // SAVEGAME_H
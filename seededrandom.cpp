@@ -0,0 +1,23 @@
+#include "seededrandom.h"
+
+SeededRandom::SeededRandom(std::uint64_t seed) : m_state(seed) {}
+
+std::uint64_t SeededRandom::next()
+{
+    // SplitMix64: identical output on every platform and standard library.
+    std::uint64_t z = (m_state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+std::uint64_t SeededRandom::bounded(std::uint64_t bound)
+{
+    std::uint64_t threshold = (0 - bound) % bound;
+    for (;;)
+    {
+        std::uint64_t value = next();
+        if (value >= threshold)
+            return value % bound;
+    }
+}
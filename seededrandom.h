@@ -0,0 +1,18 @@
+#ifndef SEEDEDRANDOM_H
+#define SEEDEDRANDOM_H
+
+#include <cstdint>
+
+class SeededRandom
+{
+public:
+    explicit SeededRandom(std::uint64_t seed);
+
+    std::uint64_t next();
+    std::uint64_t bounded(std::uint64_t bound);
+
+private:
+    std::uint64_t m_state;
+};
+
+#endif	  // SEEDEDRANDOM_H
@@ -0,0 +1,167 @@
+#include "simulator.h"
+
+#include "noguessgenerator.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+// A few frontiers take seconds to enumerate exactly; in bulk runs those fall back to the estimate early,
+// after a fixed amount of work rather than time so that results stay reproducible. The time budgets of the
+// engine and of the no-guess generator are switched off for the same reason.
+const long long GuessNodeBudget = 1 << 20;
+}	 // namespace
+
+Simulator::Simulator(const Settings &settings) : m_settings(settings) {}
+
+Simulator::Report Simulator::run() const
+{
+    // Game i always uses seed firstSeed + i and totals are integers, so a report does not depend on the thread count.
+    auto begin = std::chrono::steady_clock::now();
+    Report total;
+    std::mutex mutex;
+    std::atomic< long long > next(0);
+    auto worker = [&]()
+    {
+        BoardModel board;
+        board.setThreadCount(1);
+        Solver solver(board);
+        ProbabilityEngine probabilities(board);
+        probabilities.setThreadCount(1);
+        probabilities.setNodeBudget(GuessNodeBudget);
+        probabilities.setTimeBudget(0);
+        Report report;
+        for (long long game = next++; game < m_settings.games; game = next++)
+        {
+            ++report.games;
+            if (play(m_settings.firstSeed + game, board, solver, probabilities, report))
+                ++report.wins;
+        }
+        std::lock_guard< std::mutex > lock(mutex);
+        total.games += report.games;
+        total.wins += report.wins;
+        total.threeBV += report.threeBV;
+        total.guesses += report.guesses;
+    };
+    int threadCount = m_settings.threads > 0 ? m_settings.threads : static_cast< int >(std::max(1u, std::thread::hardware_concurrency()));
+    std::vector< std::thread > pool;
+    for (int t = 1; t < threadCount; ++t)
+        pool.emplace_back(worker);
+    worker();
+    for (std::thread &thread : pool)
+        thread.join();
+    total.seconds = std::chrono::duration< double >(std::chrono::steady_clock::now() - begin).count();
+    return total;
+}
+
+int Simulator::threeBV(const BoardModel &board)
+{
+    // One click per opening, plus one for every numbered cell that no opening reveals.
+    std::vector< char > revealed(board.cellCount(), 0);
+    std::vector< int > queue;
+    int adjacent[8];
+    int clicks = 0;
+    for (int i = 0; i < board.cellCount(); ++i)
+    {
+        if (revealed[i] || board.isMine(i) || board.adjacentMines(i) > 0)
+            continue;
+        ++clicks;
+        revealed[i] = 1;
+        queue.assign(1, i);
+        for (std::size_t next = 0; next < queue.size(); ++next)
+        {
+            int count = board.neighbours(queue[next], adjacent);
+            for (int k = 0; k < count; ++k)
+            {
+                if (revealed[adjacent[k]])
+                    continue;
+                revealed[adjacent[k]] = 1;
+                if (board.adjacentMines(adjacent[k]) == 0)
+                    queue.push_back(adjacent[k]);
+            }
+        }
+    }
+    for (int i = 0; i < board.cellCount(); ++i)
+    {
+        if (!revealed[i] && !board.isMine(i))
+            ++clicks;
+    }
+    return clicks;
+}
+
+bool Simulator::play(std::uint64_t seed, BoardModel &board, Solver &solver, ProbabilityEngine &probabilities, Report &report) const
+{
+    int start = -1;
+    if (m_settings.noGuess)
+    {
+        NoGuessGenerator generator(m_settings.width, m_settings.height, m_settings.mines);
+        generator.setThreadCount(1);
+        generator.setTimeBudget(0);
+        if (!generator.generate(seed, board, start))
+            start = -1;
+    }
+    if (start < 0)
+    {
+        // Same setup as a new game: random placement, then the first click in the centre is made safe.
+        board.reset(m_settings.width, m_settings.height);
+        board.placeMines(m_settings.mines, seed);
+        board.calculateAdjacentMines();
+        start = board.index(m_settings.height / 2, m_settings.width / 2);
+        board.clearSafeZone(start, m_settings.safeOpening, ~seed);
+    }
+    report.threeBV += threeBV(board);
+    board.openArea(start);
+    solver.reset();
+    SeededRandom random(~seed);
+    while (!board.isCleared())
+    {
+        Solver::Result result = solver.solve();
+        if (!result.safe.empty())
+        {
+            for (int cell : result.safe)
+            {
+                solver.addOpened(board.openArea(cell));
+            }
+            continue;
+        }
+        ++report.guesses;
+        int cell = guess(board, probabilities.compute(), random);
+        if (board.isMine(cell))
+            return false;
+        solver.addOpened(board.openArea(cell));
+    }
+    return true;
+}
+
+int Simulator::guess(const BoardModel &board, const ProbabilityEngine::Result &result, SeededRandom &random) const
+{
+    // The safest frontier cell, unless a random interior cell is at least as safe.
+    int best = -1;
+    double bestProbability = 2;
+    for (std::size_t i = 0; i < result.cells.size(); ++i)
+    {
+        if (result.probabilities[i] < bestProbability)
+        {
+            best = result.cells[i];
+            bestProbability = result.probabilities[i];
+        }
+    }
+    std::vector< char > frontier(board.cellCount(), 0);
+    for (int cell : result.cells)
+    {
+        frontier[cell] = 1;
+    }
+    std::vector< int > interior;
+    for (int i = 0; i < board.cellCount(); ++i)
+    {
+        if (!board.isOpened(i) && !frontier[i])
+            interior.push_back(i);
+    }
+    if (!interior.empty() && (best < 0 || result.interiorProbability <= bestProbability))
+        best = interior[random.bounded(interior.size())];
+    return best;
+}
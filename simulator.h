@@ -0,0 +1,46 @@
+#ifndef SIMULATOR_H
+#define SIMULATOR_H
+
+#include "boardmodel.h"
+#include "probabilityengine.h"
+#include "seededrandom.h"
+#include "solver.h"
+
+#include <cstdint>
+
+class Simulator
+{
+public:
+    struct Settings
+    {
+        int width = 30;
+        int height = 16;
+        int mines = 99;
+        std::uint64_t firstSeed = 1;
+        long long games = 1000;
+        int threads = 0;
+        bool safeOpening = false;
+        bool noGuess = false;
+    };
+    struct Report
+    {
+        long long games = 0;
+        long long wins = 0;
+        long long threeBV = 0;
+        long long guesses = 0;
+        double seconds = 0;
+    };
+    explicit Simulator(const Settings &settings);
+
+    Report run() const;
+
+    static int threeBV(const BoardModel &board);
+
+private:
+    bool play(std::uint64_t seed, BoardModel &board, Solver &solver, ProbabilityEngine &probabilities, Report &report) const;
+    int guess(const BoardModel &board, const ProbabilityEngine::Result &result, SeededRandom &random) const;
+
+    Settings m_settings;
+};
+
+#endif	  // SIMULATOR_H
@@ -0,0 +1,215 @@
+#include "solver.h"
+
+Solver::Solver(const BoardModel &board) : m_board(board) {}
+
+void Solver::reset()
+{
+    m_frontier.clear();
+    m_slot.assign(m_board.cellCount(), -1);
+    m_marks.assign(m_board.cellCount(), Unknown);
+    for (int i = 0; i < m_board.cellCount(); ++i)
+    {
+        if (m_board.isOpened(i) && !m_board.isMine(i) && m_board.adjacentMines(i) > 0)
+            m_frontier.push_back(i);
+    }
+}
+
+void Solver::addOpened(const std::vector< int > &opened)
+{
+    for (int cell : opened)
+    {
+        if (!m_board.isMine(cell) && m_board.adjacentMines(cell) > 0)
+            m_frontier.push_back(cell);
+    }
+}
+
+Solver::Result Solver::solve()
+{
+    Result result;
+    int adjacent[8];
+    // Numbered cells whose neighbourhood is fully opened never constrain anything again, so they leave the frontier for good.
+    std::size_t kept = 0;
+    m_constraints.clear();
+    for (int cell : m_frontier)
+    {
+        Constraint constraint;
+        constraint.cell = cell;
+        constraint.count = 0;
+        constraint.mines = m_board.adjacentMines(cell);
+        int count = m_board.neighbours(cell, adjacent);
+        for (int k = 0; k < count; ++k)
+        {
+            if (!m_board.isOpened(adjacent[k]))
+                constraint.cells[constraint.count++] = adjacent[k];
+            else if (m_board.isMine(adjacent[k]))
+                --constraint.mines;
+        }
+        if (constraint.count == 0)
+            continue;
+        m_frontier[kept++] = cell;
+        m_slot[cell] = static_cast< int >(m_constraints.size());
+        m_constraints.push_back(constraint);
+    }
+    m_frontier.resize(kept);
+
+    m_queue.clear();
+    m_queued.assign(m_constraints.size(), 1);
+    for (std::size_t id = 0; id < m_constraints.size(); ++id)
+    {
+        m_queue.push_back(static_cast< int >(id));
+    }
+    for (std::size_t next = 0; next < m_queue.size(); ++next)
+    {
+        int id = m_queue[next];
+        m_queued[id] = 0;
+        Constraint &a = m_constraints[id];
+        refresh(a);
+        if (a.count == 0)
+            continue;
+        if (a.mines == 0 || a.mines == a.count)
+        {
+            Mark mark = a.mines == 0 ? Safe : Mine;
+            for (int k = 0; k < a.count; ++k)
+            {
+                decide(a.cells[k], mark, result);
+            }
+            continue;
+        }
+        int partners[24];
+        int partnerCount = 0;
+        for (int k = 0; k < a.count; ++k)
+        {
+            int count = m_board.neighbours(a.cells[k], adjacent);
+            for (int j = 0; j < count; ++j)
+            {
+                int partner = m_slot[adjacent[j]];
+                if (partner < 0 || partner == id)
+                    continue;
+                int seen = 0;
+                while (seen < partnerCount && partners[seen] != partner)
+                    ++seen;
+                if (seen == partnerCount)
+                    partners[partnerCount++] = partner;
+            }
+        }
+        for (int k = 0; k < partnerCount; ++k)
+        {
+            Constraint &b = m_constraints[partners[k]];
+            refresh(b);
+            if (applyPair(a, b, result))
+                break;
+        }
+    }
+
+    for (int cell : result.safe)
+    {
+        m_marks[cell] = Unknown;
+    }
+    for (int cell : result.mines)
+    {
+        m_marks[cell] = Unknown;
+    }
+    for (int cell : m_frontier)
+    {
+        m_slot[cell] = -1;
+    }
+    return result;
+}
+
+void Solver::refresh(Constraint &constraint)
+{
+    int count = 0;
+    for (int k = 0; k < constraint.count; ++k)
+    {
+        int cell = constraint.cells[k];
+        if (m_marks[cell] == Mine)
+            --constraint.mines;
+        else if (m_marks[cell] == Unknown)
+            constraint.cells[count++] = cell;
+    }
+    constraint.count = count;
+}
+
+void Solver::decide(int cell, Mark mark, Result &result)
+{
+    if (m_marks[cell] != Unknown)
+        return;
+    m_marks[cell] = mark;
+    if (mark == Safe)
+        result.safe.push_back(cell);
+    else
+        result.mines.push_back(cell);
+    int adjacent[8];
+    int count = m_board.neighbours(cell, adjacent);
+    for (int k = 0; k < count; ++k)
+    {
+        int id = m_slot[adjacent[k]];
+        if (id >= 0 && !m_queued[id])
+        {
+            m_queued[id] = 1;
+            m_queue.push_back(id);
+        }
+    }
+}
+
+bool Solver::applyPair(Constraint &a, Constraint &b, Result &result)
+{
+    // With onlyA = A \ B and onlyB = B \ A: mines(A) - mines(B) = mines(onlyA) - mines(onlyB).
+    // If that difference equals |onlyA|, onlyA must be all mines and onlyB all safe (and symmetrically).
+    int onlyA[8];
+    int onlyB[8];
+    int countA = 0;
+    int countB = 0;
+    for (int i = 0; i < a.count; ++i)
+    {
+        int j = 0;
+        while (j < b.count && b.cells[j] != a.cells[i])
+            ++j;
+        if (j == b.count)
+            onlyA[countA++] = a.cells[i];
+    }
+    if (countA == a.count)
+        return false;
+    for (int i = 0; i < b.count; ++i)
+    {
+        int j = 0;
+        while (j < a.count && a.cells[j] != b.cells[i])
+            ++j;
+        if (j == a.count)
+            onlyB[countB++] = b.cells[i];
+    }
+    if (countA + countB == 0)
+        return false;
+    int difference = a.mines - b.mines;
+    const int *mines = nullptr;
+    const int *safe = nullptr;
+    int mineCount = 0;
+    int safeCount = 0;
+    if (difference == countA)
+    {
+        mines = onlyA;
+        mineCount = countA;
+        safe = onlyB;
+        safeCount = countB;
+    }
+    else if (-difference == countB)
+    {
+        mines = onlyB;
+        mineCount = countB;
+        safe = onlyA;
+        safeCount = countA;
+    }
+    else
+    {
+        return false;
+    }
+    for (int k = 0; k < mineCount; ++k)
+    {
+        decide(mines[k], Mine, result);
+    }
+    for (int k = 0; k < safeCount; ++k)
+    {
+        decide(safe[k], Safe, result);
+    }
+    return true;
+}
@@ -0,0 +1,53 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include "boardmodel.h"
+
+#include <vector>
+
+class Solver
+{
+public:
+    struct Result
+    {
+        std::vector< int > safe;
+        std::vector< int > mines;
+    };
+    explicit Solver(const BoardModel &board);
+
+    void reset();
+    void addOpened(const std::vector< int > &opened);
+
+    Result solve();
+
+private:
+    enum Mark : std::uint8_t
+    {
+        Unknown,
+        Safe,
+        Mine
+    };
+
+    struct Constraint
+    {
+        int cell;
+        int count;
+        int mines;
+        int cells[8];
+    };
+
+    void refresh(Constraint &constraint);
+    void decide(int cell, Mark mark, Result &result);
+    bool applyPair(Constraint &a, Constraint &b, Result &result);
+
+    const BoardModel &m_board;
+
+    std::vector< int > m_frontier;
+    std::vector< int > m_slot;
+    std::vector< Mark > m_marks;
+    std::vector< Constraint > m_constraints;
+    std::vector< int > m_queue;
+    std::vector< char > m_queued;
+};
+
+#endif	  // SOLVER_H
@@ -0,0 +1,23 @@
+QT       += core testlib
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+TARGET = minesweeper-tests
+
+INCLUDEPATH += ..
+
+SOURCES += \
+    ../boardmodel.cpp \
+    ../chunkedboard.cpp \
+    ../chunkedgame.cpp \
+    ../gamerules.cpp \
+    ../seededrandom.cpp \
+    tst_chunkedgame.cpp
+
+HEADERS += \
+    ../boardmodel.h \
+    ../chunkedboard.h \
+    ../chunkedgame.h \
+    ../gamerules.h \
+    ../seededrandom.h
@@ -0,0 +1,77 @@
+#include "chunkedgame.h"
+
+#include <QtTest>
+
+class ChunkedGameTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void middleClickOnHiddenZeroOpensNothing();
+    void middleClickOnOpenedNumberChords();
+};
+
+namespace
+{
+// The first safe, hidden cell with the given number of mine neighbours, or false if the board has none.
+bool findCell(ChunkedBoard &board, int adjacent, qint64 &row, qint64 &col)
+{
+    for (row = 1; row < board.height() - 1; ++row)
+    {
+        for (col = 1; col < board.width() - 1; ++col)
+        {
+            if (!board.isMine(row, col) && board.state(row, col) == BoardModel::Hidden && board.adjacentMines(row, col) == adjacent)
+                return true;
+        }
+    }
+    return false;
+}
+}	 // namespace
+
+void ChunkedGameTest::middleClickOnHiddenZeroOpensNothing()
+{
+    // Chording a cell the player has not opened would tell them its count and open its neighbours for free.
+    ChunkedBoard board;
+    board.reset(64, 64, 400, 1);
+    ChunkedGame game(board, false);
+    qint64 row;
+    qint64 col;
+    QVERIFY(findCell(board, 0, row, col));
+    game.handleCellClick(row, col, Qt::MiddleButton);
+    QCOMPARE(board.openedSafeCount(), qint64(0));
+    for (qint64 r = row - 1; r <= row + 1; ++r)
+    {
+        for (qint64 c = col - 1; c <= col + 1; ++c)
+        {
+            QCOMPARE(int(board.state(r, c)), int(BoardModel::Hidden));
+        }
+    }
+    QVERIFY(!game.isOver());
+}
+
+void ChunkedGameTest::middleClickOnOpenedNumberChords()
+{
+    ChunkedBoard board;
+    board.reset(64, 64, 400, 1);
+    ChunkedGame game(board, false);
+    qint64 row;
+    qint64 col;
+    QVERIFY(findCell(board, 1, row, col));
+    board.setState(row, col, BoardModel::Opened);
+    for (qint64 r = row - 1; r <= row + 1; ++r)
+    {
+        for (qint64 c = col - 1; c <= col + 1; ++c)
+        {
+            if (board.isMine(r, c))
+                board.setState(r, c, BoardModel::Flagged);
+        }
+    }
+    std::int64_t opened = board.openedSafeCount();
+    game.handleCellClick(row, col, Qt::MiddleButton);
+    QVERIFY(board.openedSafeCount() > opened);
+    QVERIFY(!game.isOver());
+}
+
+QTEST_GUILESS_MAIN(ChunkedGameTest)
+
+#include "tst_chunkedgame.moc"